@@ -0,0 +1,13 @@
+#ifndef THORIN_BENCH_ALLOC_H
+#define THORIN_BENCH_ALLOC_H
+
+#include <cstddef>
+
+namespace thorin::bench {
+
+/// Number of global <tt>operator new</tt> calls so far - counted by the replacement in bench/main.cpp.
+size_t num_allocs();
+
+}
+
+#endif
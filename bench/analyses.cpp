@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/domtree.h"
+#include "thorin/analyses/looptree.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+
+#include "bench/generators.h"
+
+namespace thorin::bench {
+
+static void BM_scope(benchmark::State& state) {
+    llir::World w;
+    auto k = make_cfg(w, state.range(0));
+    for (auto _ : state) {
+        Scope scope(k);
+        benchmark::DoNotOptimize(scope.defs().size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_scope_chain(benchmark::State& state) {
+    llir::World w;
+    auto k = make_chain(w, state.range(0));
+    for (auto _ : state) {
+        Scope scope(k);
+        benchmark::DoNotOptimize(scope.defs().size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_cfa(benchmark::State& state) {
+    llir::World w;
+    Scope scope(make_cfg(w, state.range(0)));
+    for (auto _ : state) {
+        CFA cfa(scope);
+        benchmark::DoNotOptimize(cfa.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_cfg(benchmark::State& state) {
+    llir::World w;
+    Scope scope(make_cfg(w, state.range(0)));
+    CFA cfa(scope);
+    for (auto _ : state) {
+        F_CFG cfg(cfa);
+        benchmark::DoNotOptimize(cfg.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_domtree(benchmark::State& state) {
+    llir::World w;
+    Scope scope(make_cfg(w, state.range(0)));
+    CFA cfa(scope);
+    F_CFG cfg(cfa);
+    for (auto _ : state) {
+        DomTree domtree(cfg);
+        benchmark::DoNotOptimize(domtree.idom(cfg.exit()));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_looptree(benchmark::State& state) {
+    llir::World w;
+    Scope scope(make_cfg(w, state.range(0)));
+    CFA cfa(scope);
+    F_CFG cfg(cfa);
+    for (auto _ : state) {
+        LoopTree<true> looptree(cfg);
+        benchmark::DoNotOptimize(looptree.root());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<Schedule::Tag tag>
+static void BM_schedule(benchmark::State& state) {
+    llir::World w;
+    Scope scope(make_cfg(w, state.range(0)));
+    scope.f_cfg().looptree(); // only measure the schedule itself
+    for (auto _ : state) {
+        auto s = schedule(scope, tag);
+        benchmark::DoNotOptimize(s.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Smart scheduling of a single block with a long chain of operations.
+static void BM_schedule_chain(benchmark::State& state) {
+    llir::World w;
+    Scope scope(make_chain(w, state.range(0)));
+    scope.f_cfg().looptree();
+    for (auto _ : state) {
+        auto s = schedule(scope, Schedule::Smart);
+        benchmark::DoNotOptimize(s.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_scope)->Range(16, 1024);
+BENCHMARK(BM_scope_chain)->Range(16, 1024);
+BENCHMARK(BM_cfa)->Range(16, 1024);
+BENCHMARK(BM_cfg)->Range(16, 1024);
+BENCHMARK(BM_domtree)->Range(16, 1024);
+BENCHMARK(BM_looptree)->Range(16, 1024);
+BENCHMARK_TEMPLATE(BM_schedule, Schedule::Early)->Range(16, 1024);
+BENCHMARK_TEMPLATE(BM_schedule, Schedule::Late )->Range(16, 1024);
+BENCHMARK_TEMPLATE(BM_schedule, Schedule::Smart)->Range(16, 1024);
+BENCHMARK(BM_schedule_chain)->Range(1024, 16384);
+
+}
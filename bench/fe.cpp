@@ -0,0 +1,72 @@
+#include <memory>
+#include <sstream>
+
+#include <benchmark/benchmark.h>
+
+#include "thorin/fe/lexer.h"
+
+#include "bench/generators.h"
+
+namespace thorin::bench {
+
+static void BM_lex(benchmark::State& state) {
+    auto str = make_module(state.range(0));
+    for (auto _ : state) {
+        fe::Lexer lexer(std::string_view(str), "bench");
+        size_t n = 0;
+        while (!lexer.lex().isa(fe::Token::Tag::Eof)) ++n;
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+/// Same as @p BM_lex but via a @c std::istream.
+static void BM_lex_stream(benchmark::State& state) {
+    auto str = make_module(state.range(0));
+    for (auto _ : state) {
+        std::istringstream is(str, std::ios::binary);
+        fe::Lexer lexer(is, "bench");
+        size_t n = 0;
+        while (!lexer.lex().isa(fe::Token::Tag::Eof)) ++n;
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+static void BM_parse_module(benchmark::State& state) {
+    auto str = make_module(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto w = std::make_unique<World>();
+        state.ResumeTiming();
+        fe::parse_module(*w, str);
+        state.PauseTiming();
+        w.reset();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+/// Parses make_module(range(0)) with range(1) threads - 1 thread is the sequential parse.
+static void BM_parse_module_parallel(benchmark::State& state) {
+    auto str = make_module(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto w = std::make_unique<World>();
+        state.ResumeTiming();
+        fe::parse_module_parallel(*w, str, "bench", state.range(1));
+        state.PauseTiming();
+        w.reset();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+BENCHMARK(BM_lex)->Range(64, 16384);
+BENCHMARK(BM_lex_stream)->Range(64, 16384);
+BENCHMARK(BM_parse_module)->Range(64, 4096);
+BENCHMARK(BM_parse_module_parallel)->Ranges({{4096, 65536}, {1, 8}})->UseRealTime();
+// ~50 MB
+BENCHMARK(BM_parse_module_parallel)->Args({1 << 20, 1})->Args({1 << 20, 8})->Iterations(1)->UseRealTime();
+
+}
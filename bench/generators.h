@@ -0,0 +1,53 @@
+#ifndef THORIN_BENCH_GENERATORS_H
+#define THORIN_BENCH_GENERATORS_H
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "thorin/llir/world.h"
+#include "thorin/fe/parser.h"
+
+#include "test/helpers.h"
+
+/// Scalable synthetic inputs for the benchmarks - see also test/helpers.h.
+namespace thorin::bench {
+
+/// A module of @p n functions @c f_i where each one calls its predecessor.
+inline std::string make_module(size_t n) {
+    std::ostringstream oss;
+    oss << "g :: Π*.* := λt.t;\n";
+    for (size_t i = 0; i != n; ++i)
+        oss << "f" << i << " :: Π*.[*, *] := λt.(" << (i == 0 ? "g" : "f" + std::to_string(i - 1)) << " t, t);\n";
+    return oss.str();
+}
+
+/**
+ * An external function with @p n basic blocks @c b_i.
+ * Each @c b_i computes a value, branches on it to @c b_i+1 and back to @c b_i/2 - this yields deeply nested loops.
+ */
+inline Lambda* make_cfg(llir::World& w, size_t n) {
+    auto k = w.lambda(fe::parse(w, "cn[int 32s64::nat, cn int 32s64::nat]")->as<Pi>(), {"k"});
+    auto x = k->param(0, {"x"});
+    auto C = w.cn(w.unit());
+    auto exit = w.lambda(C, {"exit"});
+
+    std::vector<Lambda*> blocks;
+    for (size_t i = 0; i != n; ++i)
+        blocks.emplace_back(w.lambda(C, {"b" + std::to_string(i)}));
+
+    k->br(w.op<llir::ICmp::ug>(x, w.lit_i(0_u32)), blocks.front(), exit);
+    for (size_t i = 0; i != n; ++i) {
+        auto val = w.op<llir::WOp::mul>(w.op<llir::WOp::add>(x, w.lit_i(u32(i + 1))), x);
+        auto next = i + 1 != n ? blocks[i + 1] : exit;
+        auto back = i != 0 ? blocks[i / 2] : exit;
+        blocks[i]->br(w.op<llir::ICmp::ul>(val, w.lit_i(u32(n))), next, back);
+    }
+    exit->jump(k->param(1, {"r"}), x);
+    w.make_external(k);
+    return k;
+}
+
+}
+
+#endif
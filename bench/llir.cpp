@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+
+#include "bench/generators.h"
+
+namespace thorin::bench {
+
+template<class O, O o>
+static void BM_fold_int(benchmark::State& state) {
+    llir::World w;
+    u32 i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(w.op<o>(w.lit_i(i++ % 1024), w.lit_i(42_u32)));
+}
+
+template<llir::FOp o>
+static void BM_fold_float(benchmark::State& state) {
+    llir::World w;
+    u32 i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(w.op<o>(w.lit_f(float(i++ % 1024)), w.lit_f(42.f)));
+}
+
+/// Normalizes without folding as one operand is no literal.
+static void BM_fold_param(benchmark::State& state) {
+    llir::World w;
+    auto k = make_chain(w, 1);
+    auto x = k->param(0);
+    u32 i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(w.op<llir::WOp::add>(x, w.lit_i(i++ % 1024)));
+}
+
+BENCHMARK_TEMPLATE(BM_fold_int, llir::WOp, llir::WOp::add);
+BENCHMARK_TEMPLATE(BM_fold_int, llir::WOp, llir::WOp::mul);
+BENCHMARK_TEMPLATE(BM_fold_int, llir::IOp, llir::IOp::ixor);
+BENCHMARK_TEMPLATE(BM_fold_int, llir::ICmp, llir::ICmp::ul);
+BENCHMARK_TEMPLATE(BM_fold_float, llir::FOp::fadd);
+BENCHMARK_TEMPLATE(BM_fold_float, llir::FOp::fmul);
+BENCHMARK(BM_fold_param);
+
+}
@@ -0,0 +1,41 @@
+#include <sstream>
+
+#include <benchmark/benchmark.h>
+
+#include "thorin/print.h"
+
+#include "bench/generators.h"
+
+namespace thorin::bench {
+
+static const Lambda* last_function(World& w, size_t n) {
+    fe::parse_module(w, make_module(n));
+    return w.lookup_external("f" + std::to_string(n - 1))->as<Lambda>();
+}
+
+static void BM_def_printer(benchmark::State& state) {
+    World w;
+    auto root = last_function(w, state.range(0));
+    for (auto _ : state) {
+        std::ostringstream oss;
+        DefPrinter(oss).recurse(root);
+        benchmark::DoNotOptimize(oss.tellp());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_def_writer(benchmark::State& state) {
+    World w;
+    auto root = last_function(w, state.range(0));
+    for (auto _ : state) {
+        std::ostringstream oss;
+        DefWriter(&oss).recurse(root);
+        benchmark::DoNotOptimize(oss.tellp());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_def_printer)->Range(64, 2048);
+BENCHMARK(BM_def_writer)->Range(64, 2048);
+
+}
@@ -0,0 +1,67 @@
+#include <memory>
+#include <sstream>
+
+#include <benchmark/benchmark.h>
+
+#include "thorin/serialize.h"
+
+#include "bench/generators.h"
+
+namespace thorin::bench {
+
+static std::string make_binary(size_t n) {
+    World w;
+    fe::parse_module(w, make_module(n));
+    std::ostringstream oss;
+    serialize(w, oss);
+    return oss.str();
+}
+
+static void BM_serialize(benchmark::State& state) {
+    World w;
+    fe::parse_module(w, make_module(state.range(0)));
+    for (auto _ : state) {
+        std::ostringstream oss;
+        serialize(w, oss);
+        benchmark::DoNotOptimize(oss.tellp());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_deserialize(benchmark::State& state) {
+    auto binary = make_binary(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto w = std::make_unique<World>();
+        state.ResumeTiming();
+        deserialize(*w, binary, state.range(1));
+        state.PauseTiming();
+        w.reset();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * binary.size());
+}
+
+/// Looks up a single external in a lazily loaded @p Snapshot.
+static void BM_snapshot_lookup(benchmark::State& state) {
+    auto binary = make_binary(state.range(0));
+    auto name = "f" + std::to_string(state.range(0) / 2);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto w = std::make_unique<World>();
+        state.ResumeTiming();
+        {
+            Snapshot snapshot(*w, binary);
+            benchmark::DoNotOptimize(snapshot.lookup_external(name));
+        }
+        state.PauseTiming();
+        w.reset();
+        state.ResumeTiming();
+    }
+}
+
+BENCHMARK(BM_serialize)->Range(64, 4096);
+BENCHMARK(BM_deserialize)->Ranges({{64, 4096}, {false, true}});
+BENCHMARK(BM_snapshot_lookup)->Range(64, 4096);
+
+}
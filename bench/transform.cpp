@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+
+#include "thorin/transform/mangle.h"
+
+#include "bench/generators.h"
+
+namespace thorin::bench {
+
+static void BM_drop(benchmark::State& state) {
+    llir::World w;
+    auto k = make_chain(w, state.range(0));
+    auto y = w.axiom(w.type_i(32), {"y"});
+    auto r = w.axiom(fe::parse(w, "cn int 32s64::nat"), {"r"});
+    auto x = w.axiom(w.type_i(32), {"x"});
+    for (auto _ : state)
+        benchmark::DoNotOptimize(drop(k, {x, y, r}));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_batch_drop(benchmark::State& state) {
+    llir::World w;
+    auto k = make_chain(w, state.range(0));
+    auto y = w.axiom(w.type_i(32), {"y"});
+    auto r = w.axiom(fe::parse(w, "cn int 32s64::nat"), {"r"});
+    auto x = w.axiom(w.type_i(32), {"x"});
+    Scope scope(k);
+    BatchMangler batch(scope);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(batch.drop({x, y, r}));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_drop)->Range(16, 1024);
+BENCHMARK(BM_batch_drop)->Range(16, 1024);
+
+}
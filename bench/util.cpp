@@ -0,0 +1,103 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "thorin/util/bitset.h"
+#include "thorin/util/symbol.h"
+
+namespace thorin::bench {
+
+//------------------------------------------------------------------------------
+
+/*
+ * BitSet
+ */
+
+static std::vector<BitSet> random_bitsets(size_t num, size_t size) {
+    std::mt19937 rng(42);
+    std::vector<BitSet> sets(num);
+    for (auto& set : sets) {
+        for (size_t i = 0; i != size; ++i) {
+            if (rng() % 3 == 0) set.set(i);
+        }
+    }
+    return sets;
+}
+
+static void BM_bitset_or_then_shr(benchmark::State& state) {
+    auto sets = random_bitsets(256, state.range(0));
+    for (auto _ : state) {
+        BitSet res;
+        for (size_t i = 0; i != sets.size(); ++i)
+            res |= sets[i] >> (i % 128);
+        benchmark::DoNotOptimize(res.any());
+    }
+    state.SetItemsProcessed(state.iterations() * sets.size());
+}
+
+static void BM_bitset_or_shr(benchmark::State& state) {
+    auto sets = random_bitsets(256, state.range(0));
+    for (auto _ : state) {
+        BitSet res;
+        for (size_t i = 0; i != sets.size(); ++i)
+            res.or_shr(sets[i], i % 128);
+        benchmark::DoNotOptimize(res.any());
+    }
+    state.SetItemsProcessed(state.iterations() * sets.size());
+}
+
+static void BM_bitset_queries(benchmark::State& state) {
+    auto sets = random_bitsets(256, state.range(0));
+    for (auto _ : state) {
+        size_t n = 0;
+        for (size_t i = 0; i != sets.size(); ++i)
+            n += sets[i].intersects(sets[sets.size() - 1 - i]) + sets[i].any_range(64, state.range(0) - 64) + sets[i].count();
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * sets.size());
+}
+
+BENCHMARK(BM_bitset_or_then_shr)->Range(256, 4096);
+BENCHMARK(BM_bitset_or_shr)->Range(256, 4096);
+BENCHMARK(BM_bitset_queries)->Range(256, 4096);
+
+//------------------------------------------------------------------------------
+
+/*
+ * Symbol
+ */
+
+static std::vector<std::string> make_strings(size_t num) {
+    std::vector<std::string> strs;
+    for (size_t i = 0; i != num; ++i)
+        strs.emplace_back("symbol_" + std::to_string(i));
+    return strs;
+}
+
+static void BM_symbol_intern(benchmark::State& state) {
+    auto strs = make_strings(state.range(0));
+    for (auto _ : state) {
+        for (auto& str : strs)
+            benchmark::DoNotOptimize(Symbol(str).c_str());
+    }
+    state.SetItemsProcessed(state.iterations() * strs.size());
+}
+
+static void BM_symbol_compare(benchmark::State& state) {
+    auto strs = make_strings(state.range(0));
+    std::vector<Symbol> symbols(strs.begin(), strs.end());
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (size_t i = 0, e = strs.size(); i != e; ++i)
+            hits += symbols[i] == strs[i].c_str();
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * strs.size());
+}
+
+BENCHMARK(BM_symbol_intern)->Range(1024, 65536);
+BENCHMARK(BM_symbol_compare)->Range(1024, 65536);
+
+}
@@ -0,0 +1,203 @@
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "thorin/check.h"
+#include "thorin/transform/reduce.h"
+
+#include "bench/alloc.h"
+#include "bench/generators.h"
+
+namespace thorin::bench {
+
+//------------------------------------------------------------------------------
+
+/*
+ * construction
+ */
+
+static void BM_world(benchmark::State& state) {
+    for (auto _ : state) {
+        World w;
+        benchmark::DoNotOptimize(w.defs().size());
+    }
+}
+
+static void BM_world_bootstrap(benchmark::State& state) {
+    for (auto _ : state) {
+        World w(World::Bootstrap{});
+        benchmark::DoNotOptimize(w.defs().size());
+    }
+}
+
+static void BM_llir_world(benchmark::State& state) {
+    for (auto _ : state) {
+        llir::World w;
+        benchmark::DoNotOptimize(w.defs().size());
+    }
+}
+
+static void BM_llir_world_bootstrap(benchmark::State& state) {
+    for (auto _ : state) {
+        llir::World w(World::Bootstrap{});
+        benchmark::DoNotOptimize(w.defs().size());
+    }
+}
+
+BENCHMARK(BM_world);
+BENCHMARK(BM_world_bootstrap);
+BENCHMARK(BM_llir_world);
+BENCHMARK(BM_llir_world_bootstrap);
+
+//------------------------------------------------------------------------------
+
+/*
+ * hash-consing
+ */
+
+static void BM_unify_hit(benchmark::State& state) {
+    World w;
+    for (int64_t i = 0; i != 1024; ++i)
+        w.lit_nat(i);
+
+    int64_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(w.lit_nat(i++ % 1024));
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_unify_miss(benchmark::State& state) {
+    auto w = std::make_unique<World>();
+    int64_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(w->lit_nat(i++));
+        if (i % (1 << 16) == 0) { // bound the memory
+            state.PauseTiming();
+            w = std::make_unique<World>();
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_unify_hit);
+BENCHMARK(BM_unify_miss);
+
+//------------------------------------------------------------------------------
+
+/*
+ * tuple, sigma and pack
+ */
+
+static void BM_tuple(benchmark::State& state) {
+    World w;
+    DefArray ops(state.range(0), [&](auto i) { return w.lit_nat(i); });
+    for (auto _ : state)
+        benchmark::DoNotOptimize(w.tuple(ops));
+    state.SetItemsProcessed(state.iterations() * ops.size());
+}
+
+static void BM_sigma(benchmark::State& state) {
+    World w;
+    DefArray ops(state.range(0), [&](auto i) { return i % 2 == 0 ? w.type_nat() : w.type_bool(); });
+    for (auto _ : state)
+        benchmark::DoNotOptimize(w.sigma(ops));
+    state.SetItemsProcessed(state.iterations() * ops.size());
+}
+
+static void BM_pack(benchmark::State& state) {
+    World w;
+    int64_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(w.pack(state.range(0), w.lit_nat(i++ % 1024)));
+}
+
+BENCHMARK(BM_tuple)->Range(8, 512);
+BENCHMARK(BM_sigma)->Range(8, 512);
+BENCHMARK(BM_pack)->Range(8, 512);
+
+//------------------------------------------------------------------------------
+
+/*
+ * reduce, shift_free_vars and unfold
+ */
+
+/// A tuple of @p n pairs which all contain the free variable 0.
+static const Def* make_open_tuple(World& w, size_t n) {
+    auto var = w.var(w.type_nat(), 0);
+    return w.tuple(DefArray(n, [&](auto i) { return w.tuple({var, w.lit_nat(i + 1)}); }));
+}
+
+static void BM_reduce(benchmark::State& state) {
+    World w;
+    auto def = make_open_tuple(w, state.range(0));
+    int64_t i = 0;
+    auto allocs = num_allocs();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(reduce(def, w.lit_nat(i++ % 64)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["allocs/node"] = double(num_allocs() - allocs) / double(state.iterations() * state.range(0));
+}
+
+static void BM_shift_free_vars(benchmark::State& state) {
+    World w;
+    auto def = make_open_tuple(w, state.range(0));
+    int64_t i = 0;
+    auto allocs = num_allocs();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(shift_free_vars(def, 1 + i++ % 8));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["allocs/node"] = double(num_allocs() - allocs) / double(state.iterations() * state.range(0));
+}
+
+static void BM_unfold(benchmark::State& state) {
+    std::unique_ptr<World> w;
+    const Def* f = nullptr;
+    auto init = [&] {
+        w = std::make_unique<World>();
+        fe::parse_module(*w, "f :: Πnat.[nat, nat] := λn.(n, n);");
+        f = w->lookup_external("f");
+    };
+    init();
+
+    int64_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(w->app(f, w->lit_nat(i++))->as<App>()->unfold());
+        if (i % (1 << 14) == 0) { // bound the memory
+            state.PauseTiming();
+            init();
+            state.ResumeTiming();
+        }
+    }
+}
+
+BENCHMARK(BM_reduce)->Range(8, 512);
+BENCHMARK(BM_shift_free_vars)->Range(8, 512);
+BENCHMARK(BM_unfold);
+
+//------------------------------------------------------------------------------
+
+/*
+ * type checking
+ */
+
+/// Checks all closed structural Def%s of an llir::World from scratch.
+static void BM_type_check(benchmark::State& state) {
+    llir::World w;
+    std::vector<const Def*> defs;
+    for (auto def : w.defs()) {
+        if (!def->is_nominal() && def->free_vars().none())
+            defs.emplace_back(def);
+    }
+
+    for (auto _ : state) {
+        TypeCheck tc;
+        for (auto def : defs)
+            tc.check(def);
+    }
+    state.SetItemsProcessed(state.iterations() * defs.size());
+}
+
+BENCHMARK(BM_type_check);
+
+}
@@ -0,0 +1,85 @@
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "thorin/llir/world.h"
+#include "thorin/analyses/manager.h"
+#include "thorin/fe/parser.h"
+
+namespace thorin::llir {
+
+using Analysis = AnalysisManager::Analysis;
+
+TEST(Analyses, Memoize) {
+    World w;
+    auto C = w.cn(w.unit());
+    auto k = w.lambda(fe::parse(w, "cn[int 32s64::nat, cn int 32s64::nat]")->as<Pi>(), {"k"});
+    auto x = k->param(0, {"x"});
+    auto r = k->param(1, {"r"});
+    auto head = w.lambda(fe::parse(w, "cn[int 32s64::nat]")->as<Pi>(), {"head"});
+    auto body = w.lambda(C, {"body"});
+    auto exit = w.lambda(C, {"exit"});
+    auto i = head->param({"i"});
+    k->jump(head, w.lit_i(0_u32));
+    head->br(w.op<ICmp::ul>(i, x), body, exit);
+    body->jump(head, w.op<WOp::add>(i, w.lit_i(1_u32)));
+    exit->jump(r, i);
+    w.make_external(k);
+
+    Scope scope(k);
+    auto& am = scope.analyses();
+    for (size_t i = 0; i != AnalysisManager::Num; ++i)
+        EXPECT_FALSE(am.is_valid(Analysis(i)));
+
+    // the schedule pulls in all its dependencies exactly once
+    auto& schedule = am.schedule();
+    EXPECT_EQ(&schedule, &am.schedule());
+    EXPECT_EQ(&scope.f_cfg().domtree(), &am.domtree<true>());
+    EXPECT_EQ(&scope.f_cfg().looptree(), &am.looptree<true>());
+    for (auto a : {Analysis::CFA, Analysis::F_CFG, Analysis::DomTree, Analysis::F_LoopTree, Analysis::Schedule}) {
+        EXPECT_TRUE(am.is_valid(a));
+        EXPECT_EQ(am.stats(a).builds, 1u);
+    }
+    EXPECT_FALSE(am.is_valid(Analysis::B_CFG));
+    EXPECT_FALSE(am.is_valid(Analysis::PostDomTree));
+
+    // different tags are memoized separately
+    am.schedule(Schedule::Early);
+    am.schedule(Schedule::Early);
+    EXPECT_EQ(am.stats(Analysis::Schedule).builds, 2u);
+
+    // only the dependents are invalidated
+    scope.b_cfg().domtree();
+    am.invalidate(Analysis::F_LoopTree);
+    EXPECT_TRUE (am.is_valid(Analysis::DomTree));
+    EXPECT_TRUE (am.is_valid(Analysis::PostDomTree));
+    EXPECT_FALSE(am.is_valid(Analysis::F_LoopTree));
+    EXPECT_FALSE(am.is_valid(Analysis::Schedule));
+
+    am.invalidate(Analysis::F_CFG);
+    EXPECT_TRUE (am.is_valid(Analysis::CFA));
+    EXPECT_TRUE (am.is_valid(Analysis::PostDomTree));
+    EXPECT_FALSE(am.is_valid(Analysis::DomTree));
+
+    am.schedule();
+    EXPECT_EQ(am.stats(Analysis::F_CFG).builds, 2u);
+    EXPECT_EQ(am.stats(Analysis::DomTree).builds, 2u);
+    EXPECT_EQ(am.stats(Analysis::Schedule).builds, 3u);
+
+    // update drops everything but keeps the statistics
+    scope.update();
+    EXPECT_TRUE(scope.contains(i));
+    for (size_t i = 0; i != AnalysisManager::Num; ++i)
+        EXPECT_FALSE(am.is_valid(Analysis(i)));
+    EXPECT_EQ(am.stats(Analysis::CFA).builds, 1u);
+    scope.f_cfg();
+    EXPECT_EQ(am.stats(Analysis::CFA).builds, 2u);
+
+    std::ostringstream oss;
+    Printer p(oss);
+    am.stream(p);
+    EXPECT_NE(oss.str().find("CFA: 2 builds"), std::string::npos);
+    EXPECT_NE(oss.str().find("Schedule: 3 builds"), std::string::npos);
+}
+
+}
@@ -0,0 +1,37 @@
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "thorin/util/array.h"
+
+namespace thorin {
+
+TEST(Array, Inline) {
+    static_assert(Array<int*>::Inline == 4);
+    static_assert(Array<std::string>::Inline == 0);
+
+    Array<int> a(3, [](size_t i) { return int(i) * 2; });
+    Array<int> b(a);
+    Array<int> c(Array<int>::Inline + 1, 7);
+    EXPECT_EQ(a, Array<int>({0, 2, 4}));
+    EXPECT_EQ(Array<int>(5), Array<int>(size_t(5), 0));
+
+    // inline with inline, inline with heap and back
+    swap(a, c);
+    EXPECT_EQ(a.size(), Array<int>::Inline + 1);
+    EXPECT_EQ(c, b);
+    c = std::move(a);
+    EXPECT_EQ(c, Array<int>(Array<int>::Inline + 1, 7));
+    a = b;
+    EXPECT_EQ(a, b);
+    a.shrink(1);
+    Array<int> d(std::move(a));
+    EXPECT_EQ(d, Array<int>({0}));
+    EXPECT_TRUE(a.empty());
+
+    Array<std::string> s(2, [](size_t i) { return std::to_string(i); });
+    Array<std::string> t(std::move(s));
+    EXPECT_EQ(t, Array<std::string>({"0", "1"}));
+}
+
+}
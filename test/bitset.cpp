@@ -1,3 +1,5 @@
+#include <random>
+
 #include "gtest/gtest.h"
 
 #include "thorin/util/bitset.h"
@@ -105,3 +107,63 @@ TEST(Bitset, ShiftOutside64) {
     EXPECT_TRUE(b.test(20));
     EXPECT_EQ(b.count(), size_t(1));
 }
+
+TEST(Bitset, ShiftWholeWords) {
+    BitSet b;
+    b.set(3).set(64).set(200);
+    b >>= 64;
+    EXPECT_TRUE(b.test(0));
+    EXPECT_TRUE(b.test(136));
+    EXPECT_EQ(b.count(), size_t(2));
+    b <<= 128;
+    EXPECT_TRUE(b.test(128));
+    EXPECT_TRUE(b.test(264));
+    EXPECT_EQ(b.count(), size_t(2));
+}
+
+TEST(Bitset, ShiftLeft) {
+    BitSet b;
+    b.set(0).set(63).set(100);
+    b <<= 3;
+    EXPECT_TRUE(b.test(3));
+    EXPECT_TRUE(b.test(66));
+    EXPECT_TRUE(b.test(103));
+    EXPECT_EQ(b.count(), size_t(3));
+    EXPECT_EQ(b, (b << 200) >> 200);
+    EXPECT_EQ(b.find_first(), size_t(3));
+    EXPECT_EQ(b.find_last(), size_t(103));
+}
+
+TEST(Bitset, And) {
+    BitSet b, c;
+    b.set(3).set(7).set(300);
+    c.set(7);
+    EXPECT_TRUE(b.intersects(c));
+    EXPECT_FALSE(b.intersects(BitSet().set(4).set(301)));
+    b &= c;
+    EXPECT_EQ(b, c);
+    EXPECT_EQ(b.hash(), c.hash());
+    EXPECT_FALSE(b.test(300));
+}
+
+static BitSet random_bitset(std::mt19937& rng, size_t num_bits) {
+    BitSet b;
+    for (size_t i = 0; i != num_bits / 8; ++i)
+        b.set(rng() % num_bits);
+    return b;
+}
+
+TEST(Bitset, Fused) {
+    std::mt19937 rng(23);
+    for (size_t i = 0; i != 200; ++i) {
+        auto a = random_bitset(rng, 1 + rng() % 700);
+        auto b = random_bitset(rng, 1 + rng() % 700);
+        uint64_t shift = rng() % 300;
+        size_t begin = rng() % 400, end = begin + rng() % 400;
+
+        EXPECT_EQ(BitSet(a).or_shr(b, shift), a | (b >> shift));
+        EXPECT_EQ(a.any_range_shr(shift, begin, end), (a >> shift).any_range(begin, end));
+        EXPECT_EQ(a.intersects(b), (a & b).any());
+        EXPECT_EQ((a << shift) >> shift, a);
+    }
+}
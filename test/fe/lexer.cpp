@@ -1,9 +1,12 @@
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 #include <string>
 
 #include "thorin/fe/lexer.h"
+#include "thorin/util/mmap.h"
 
 using namespace thorin;
 using namespace thorin::fe;
@@ -148,3 +151,62 @@ TEST(Lexer, Eof) {
         EXPECT_TRUE(lexer.lex().isa(Token::Tag::Eof));
     }
 }
+
+static void expect_same_tokens(const std::string& str) {
+    std::istringstream is(str, std::ios::binary);
+    Lexer stream_lexer(is, "stdin");
+    Lexer buffer_lexer(std::string_view(str), "stdin");
+
+    while (true) {
+        auto s = stream_lexer.lex();
+        auto b = buffer_lexer.lex();
+        EXPECT_EQ(s.tag(), b.tag());
+        EXPECT_EQ(s.loc(), b.loc());
+        if (s.isa(Token::Tag::Identifier)) {
+            EXPECT_EQ(s.symbol(), b.symbol());
+        }
+        if (s.isa(Token::Tag::Literal)) {
+            EXPECT_EQ(s.literal().box, b.literal().box);
+        }
+        if (s.isa(Token::Tag::Eof) || b.isa(Token::Tag::Eof)) break;
+    }
+}
+
+TEST(Lexer, Buffer) {
+    expect_same_tokens(u8"\ufeffΠ λ ℚ");
+    expect_same_tokens(" test  abc    def if  \nwhile   foo   ");
+    expect_same_tokens("\t\t  a_very_long_identifier_spanning_more_than_32_bytes\t  \n x1\ty2  cn bool 0ₐ 0₁ -0xFFs32 1.0f32");
+    expect_same_tokens("\\lambda x: int 32s64::nat. add_with_some_name(x, x) λ«y»");
+    expect_same_tokens("");
+
+    std::string str = "abc def";
+    Lexer lexer(std::string_view(str).substr(0, 5), "stdin");
+    EXPECT_EQ(lexer.lex().symbol(), "abc");
+    EXPECT_EQ(lexer.lex().symbol(), "d");
+    EXPECT_TRUE(lexer.lex().isa(Token::Tag::Eof));
+}
+
+TEST(Lexer, MappedFile) {
+    std::string filename = "lexer_mapped_file.thorin";
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        for (size_t i = 0; i != 1000; ++i)
+            ofs << "\\lambda some_value_" << i << ": int 32s64::nat. add_with_overflow(some_value_" << i << ", 42s32)\n";
+    }
+
+    auto count = [](Lexer& lexer) {
+        size_t n = 0;
+        while (!lexer.lex().isa(Token::Tag::Eof)) ++n;
+        return n;
+    };
+
+    std::ifstream ifs(filename, std::ios::binary);
+    Lexer stream_lexer(ifs, filename.c_str());
+    auto n_stream = count(stream_lexer);
+    MappedFile file(filename.c_str());
+    Lexer buffer_lexer(file.view(), file.filename());
+    auto n_buffer = count(buffer_lexer);
+
+    EXPECT_EQ(n_stream, n_buffer);
+    std::remove(filename.c_str());
+}
@@ -1,5 +1,7 @@
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 #include <string>
 
@@ -223,3 +225,130 @@ TEST(Parser, NominalLambda) {
 // TODO nominal sigma tests
 // TEST(Parser, NominalSigma) {
 // }
+
+TEST(Parser, Module) {
+    World w;
+    auto S = w.kind_star();
+    parse_module(w, "K = *;\n"
+                    "id :: ΠK.K := λt.t;\n"
+                    "pair :: Π*.[*,*] := λt.(id t, t);\n");
+    EXPECT_EQ(w.externals().size(), 2u);
+    auto id   = w.lookup_external("id");
+    auto pair = w.lookup_external("pair");
+    ASSERT_TRUE(id != nullptr && pair != nullptr);
+    check_nominal(id,   Def::Tag::Lambda, w.pi(S, S));
+    check_nominal(pair, Def::Tag::Lambda, w.pi(S, w.sigma({S, S})));
+    EXPECT_EQ(parse(w, "pair"), pair);
+
+    EXPECT_THROW(parse_module(w, "id :: Π*.* := λt.t;"), std::logic_error);
+    EXPECT_THROW(parse_module(w, "x = *"), std::logic_error);
+}
+
+TEST(Parser, NominalNoLambda) {
+    World w;
+    EXPECT_THROW(parse_module(w, "s :: * := [*, *];"), std::logic_error);
+    EXPECT_THROW(parse_module(w, "f :: Π*.* := *;"), std::logic_error);
+    EXPECT_THROW(parse(w, "s :: * := [*, *]; s"), std::logic_error);
+    try {
+        parse(w, "g :: Π*.* := *; g");
+        FAIL();
+    } catch (const std::logic_error& e) {
+        EXPECT_NE(std::string(e.what()).find("only nominal lambdas are supported"), std::string::npos) << e.what();
+    }
+}
+
+TEST(Parser, ModuleFile) {
+    std::string filename = "parser_module_file.thorin";
+    size_t num = 1000;
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        for (size_t i = 0; i != num; ++i)
+            ofs << "f" << i << " :: Π*.* := λt." << (i == 0 ? "t" : "f" + std::to_string(i - 1) + " t") << ";\n";
+    }
+
+    World w;
+    parse_module_file(w, filename.c_str());
+    EXPECT_EQ(w.externals().size(), num);
+    auto last = w.lookup_external("f" + std::to_string(num - 1));
+    ASSERT_TRUE(last != nullptr);
+    EXPECT_EQ(last->type(), w.pi(w.kind_star(), w.kind_star()));
+    std::remove(filename.c_str());
+
+    EXPECT_THROW(parse_module_file(w, filename.c_str()), std::runtime_error);
+}
+
+static std::string make_module(size_t num) {
+    std::ostringstream oss;
+    oss << "K = *;\n";
+    oss << "g :: ΠK.K;\n";
+    for (size_t i = 0; i != num; ++i) {
+        oss << "f" << i << " :: Π*.K := λt.\n";
+        oss << "    " << (i == 0 ? "g" : "f" + std::to_string(i - 1)) << " t;\n";
+    }
+    oss << "g :: Π*.* := λt.t;\n";
+    return oss.str();
+}
+
+TEST(Parser, Parallel) {
+    auto str = make_module(1000);
+    World sequential;
+    World parallel;
+    parse_module(sequential, str);
+    parse_module_parallel(parallel, str, "stdin", 4);
+
+    EXPECT_EQ(sequential.externals().size(), 1001u);
+    EXPECT_EQ(parallel.externals().size(), 1001u);
+    for (auto [name, def] : sequential.externals()) {
+        auto l1 = def->as<Lambda>();
+        auto l2 = parallel.lookup_external(name)->as<Lambda>();
+        ASSERT_TRUE(l1->body() != nullptr && l2->body() != nullptr);
+        EXPECT_EQ(&l2->world(), &parallel);
+        if (auto app = l1->body()->isa<App>()) {
+            EXPECT_EQ(app->callee()->name(), l2->body()->as<App>()->callee()->name());
+        }
+    }
+    EXPECT_EQ(parallel.lookup_external("f0")->as<Lambda>()->body()->as<App>()->callee(), parallel.lookup_external("g"));
+
+    EXPECT_THROW(parse_module_parallel(parallel, "x = *;\ny = x;\nz :: Π*.* := λt.w;\n", "stdin", 2), std::logic_error);
+}
+
+TEST(Parser, ParallelRedefinition) {
+    // each definition lands in a chunk of its own
+    auto str = "f :: Π*.* := λt.t;\nf :: Π*.* := λt.t;\n";
+    World sequential;
+    World parallel;
+    EXPECT_THROW(parse_module(sequential, str), std::logic_error);
+    try {
+        parse_module_parallel(parallel, str, "stdin", 4);
+        FAIL();
+    } catch (const std::logic_error& e) {
+        EXPECT_NE(std::string(e.what()).find("stdin:2"), std::string::npos) << e.what();
+        EXPECT_NE(std::string(e.what()).find("stdin:1"), std::string::npos) << e.what();
+    }
+}
+
+TEST(Parser, ParallelPrelude) {
+    // each chunk only declares the nominals it refers to - directly or via the let l
+    auto str = "a :: Π*.* := λt.t;\nb :: Π*.* := λt.t;\nl = a;\nc :: Π*.* := λt.l t;\nd :: Π*.* := λt.b (a t);\n";
+    World parallel;
+    parse_module_parallel(parallel, str, "stdin", 8);
+    EXPECT_EQ(parallel.externals().size(), 4u);
+    auto a = parallel.lookup_external("a");
+    auto b = parallel.lookup_external("b");
+    EXPECT_EQ(parallel.lookup_external("c")->as<Lambda>()->body()->as<App>()->callee(), a);
+    auto d = parallel.lookup_external("d")->as<Lambda>()->body()->as<App>();
+    EXPECT_EQ(d->callee(), b);
+    EXPECT_EQ(d->arg()->as<App>()->callee(), a);
+}
+
+TEST(Parser, ParallelFallback) {
+    // the body of f continues in the first column - so this must not be split there
+    auto str = "g :: Π*.* := λt.t;\nf :: Π*.* := λt.\ng t;\nh :: Π*.* := λt.f t;\n";
+    World sequential;
+    World parallel;
+    parse_module(sequential, str);
+    parse_module_parallel(parallel, str, "stdin", 4);
+    EXPECT_EQ(sequential.externals().size(), 3u);
+    EXPECT_EQ(parallel.externals().size(), 3u);
+    EXPECT_EQ(parallel.lookup_external("h")->as<Lambda>()->body()->as<App>()->callee(), parallel.lookup_external("f"));
+}
@@ -0,0 +1,38 @@
+#ifndef THORIN_TEST_HELPERS_H
+#define THORIN_TEST_HELPERS_H
+
+#include <utility>
+
+#include "thorin/llir/world.h"
+#include "thorin/fe/parser.h"
+
+/// Fixtures shared by the tests and the benchmarks.
+namespace thorin {
+
+/**
+ * Creates the external @c k(x, y, r) of type @c cn[int 32s64::nat, int 32s64::nat, cn int 32s64::nat].
+ * Returns @c k together with @c ((x * y) + x) * y ... which consists of @p n alternating multiplications and additions.
+ * The body of @c k is up to the caller.
+ */
+inline std::pair<Lambda*, const Def*> make_chain_kernel(llir::World& w, size_t n) {
+    auto k = w.lambda(fe::parse(w, "cn[int 32s64::nat, int 32s64::nat, cn int 32s64::nat]")->as<Pi>(), {"k"});
+    auto x = k->param(0, {"x"});
+    auto y = k->param(1, {"y"});
+
+    const Def* cur = x;
+    for (size_t i = 0; i != n; ++i)
+        cur = i % 2 == 0 ? w.op<llir::WOp::mul>(cur, y) : w.op<llir::WOp::add>(cur, x);
+    w.make_external(k);
+    return {k, cur};
+}
+
+/// Same as @p make_chain_kernel but @c k returns the chain via @c r.
+inline Lambda* make_chain(llir::World& w, size_t n) {
+    auto [k, cur] = make_chain_kernel(w, n);
+    k->jump(k->param(2, {"r"}), cur);
+    return k;
+}
+
+}
+
+#endif
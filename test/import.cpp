@@ -0,0 +1,69 @@
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "thorin/transform/import.h"
+#include "thorin/fe/parser.h"
+
+namespace thorin {
+
+static std::string make_module(size_t num) {
+    std::ostringstream oss;
+    oss << "g :: Π*.*;\n";
+    for (size_t i = 0; i != num; ++i)
+        oss << "f" << i << " :: Π*.[*, *] := λt.(" << (i == 0 ? "g" : "f" + std::to_string(i - 1)) << " t, t);\n";
+    return oss.str();
+}
+
+static void import_externals(World& src, Importer& importer) {
+    for (auto [name, def] : src.externals())
+        importer.world().make_external(importer.import(def));
+}
+
+TEST(Import, Copy) {
+    World src;
+    fe::parse_module(src, make_module(100));
+    Importer importer(src);
+    import_externals(src, importer);
+    auto& dst = importer.world();
+
+    EXPECT_EQ(dst.externals().size(), 101u);
+    auto f1 = dst.lookup_external("f1")->as<Lambda>();
+    EXPECT_EQ(dst.extract(f1->body(), 0_u64)->as<App>()->callee(), dst.lookup_external("f0"));
+    EXPECT_EQ(dst.extract(f1->body(), 1_u64), f1->param());
+    EXPECT_EQ(dst.lookup_external("g")->as<Lambda>()->body(), nullptr);
+    EXPECT_FALSE(importer.todo());
+
+    // most externals are already imported while importing another one
+    EXPECT_GT(importer.stats().shared, 50u);
+    EXPECT_GT(importer.stats().copied, 4 * 100u);
+}
+
+TEST(Import, Incremental) {
+    World src;
+    fe::parse_module(src, make_module(1000));
+    World dst;
+    auto importer = Importer::into(dst);
+    import_externals(src, importer);
+    auto stats = importer.stats();
+    EXPECT_EQ(stats.refilled, 0u);
+
+    // nothing changed
+    importer.next_round();
+    import_externals(src, importer);
+    EXPECT_EQ(importer.stats().copied, stats.copied);
+    EXPECT_EQ(importer.stats().refilled, 0u);
+
+    // define g: only g is imported again although all f_i depend on it
+    auto g = src.lookup_external("g")->as_lambda();
+    g->set(src.lit_true(), g->param());
+    importer.next_round();
+    import_externals(src, importer);
+    EXPECT_EQ(importer.stats().refilled, 1u);
+    EXPECT_LT(importer.stats().copied - stats.copied, 5u);
+    auto new_g = dst.lookup_external("g")->as<Lambda>();
+    EXPECT_EQ(new_g->body(), new_g->param());
+    EXPECT_EQ(dst.extract(dst.lookup_external("f0")->as<Lambda>()->body(), 0_u64)->as<App>()->callee(), new_g);
+}
+
+}
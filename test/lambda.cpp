@@ -14,6 +14,24 @@ TEST(Pi, Kinds) {
     EXPECT_EQ(w.pi(w.type_nat(), w.sigma({w.lit_arity(2), w.lit_arity(3)}))->type(), w.kind_star());
 }
 
+TEST(Lambda, FreeVars) {
+    World w;
+    auto x = w.var(w.type_nat(), 0);
+    auto y = w.var(w.type_nat(), 2);
+    auto t = w.tuple({x, y});
+    // interned: equal sets are the same object
+    EXPECT_EQ(&t->free_vars(), &w.tuple({y, x})->free_vars());
+    EXPECT_EQ(&x->free_vars(), &w.lambda(w.type_nat(), w.var(w.type_nat(), 1))->free_vars());
+    EXPECT_EQ(&w.lambda(w.type_nat(), x)->free_vars(), &FreeVars::empty());
+    EXPECT_EQ(t->free_vars().min(), 0u);
+    EXPECT_EQ(t->free_vars().max(), 2u);
+    EXPECT_FALSE(t->free_vars().any_range(1, 2));
+    EXPECT_TRUE(t->free_vars().any_range(1, 3));
+    EXPECT_TRUE(t->free_vars().none_begin(3));
+    EXPECT_TRUE(w.lambda(w.type_nat(), t)->free_vars().test(1));
+    EXPECT_TRUE(w.lambda(w.type_nat(), t)->free_vars().none_end(1));
+}
+
 TEST(Lambda, PolyId) {
     World w;
     auto n16 = w.lit_nat_16();
@@ -100,6 +118,56 @@ TEST(Lambda, AppArity) {
     EXPECT_EQ(r, w.lit_nat_32());
 }
 
+TEST(Lambda, UnfoldGeneration) {
+    World w;
+    auto N = w.type_nat();
+    auto a = w.axiom(N, {"a"});
+    auto b = w.axiom(N, {"b"});
+    auto f = w.lambda(w.pi(N, N), {"f"})->set(a);
+    auto app = w.app(f, w.lit_nat(23))->as<App>();
+    EXPECT_EQ(app->unfold(), a);
+
+    // re-setting the nominal invalidates the cached unfold
+    auto gen = f->generation();
+    f->reset(b);
+    EXPECT_GT(f->generation(), gen);
+    EXPECT_EQ(app->unfold(), b);
+    EXPECT_EQ(app->unfold(), b);
+}
+
+TEST(Lambda, UnfoldGenerationNested) {
+    World w;
+    auto N = w.type_nat();
+    auto g = w.axiom(w.pi(N, N), {"g"});
+    auto n23 = w.lit_nat(23);
+    auto f = w.lambda(w.pi(N, N), {"f"});
+    auto h = w.lambda(w.pi(N, N), {"h"});
+    f->set(w.app(h, w.lit_nat(42)));
+    h->set(f->param());
+
+    // h is nested within the Scope of f and, thus, rebuilt by the unfold
+    auto app = w.app(f, n23)->as<App>();
+    auto unfolded_h = [&] { return app->unfold()->as<App>()->callee()->as<Lambda>(); };
+    EXPECT_NE(unfolded_h(), h);
+    EXPECT_EQ(unfolded_h()->body(), n23);
+
+    // re-setting h invalidates the cached unfold of f as well
+    h->reset(w.app(g, f->param()));
+    EXPECT_EQ(unfolded_h()->body(), w.app(g, n23));
+}
+
+TEST(Lambda, UnfoldAffine) {
+    World w;
+    auto N = w.type_nat();
+    auto l = w.lambda(w.lit(Qualifier::a), N, w.lit_true(), w.var(N, 0));
+    auto n23 = w.lit_nat(23);
+    auto app = w.app(l, n23)->as<App>(); // not reduced by World::app
+    EXPECT_FALSE(w.affine_unfolds().contains(app));
+    EXPECT_EQ(app->unfold(), n23);
+    EXPECT_EQ(find(w.affine_unfolds(), app), n23);
+    EXPECT_EQ(app->unfold(), n23);
+}
+
 TEST(Lambda, EtaConversion) {
     World w;
     auto N = w.type_nat();
@@ -0,0 +1,125 @@
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "thorin/llir/fold.h"
+
+namespace thorin::llir {
+
+typedef          __int128 s128;
+typedef unsigned __int128 u128;
+
+/**
+ * Reference: the result of @p op in 128 bits which is exact for all operands up to 64 bits.
+ * The only exception is an unsigned result below zero which wraps around to something larger than any 64 bit value.
+ */
+template<class R>
+R exact(WOp op, R a, R b) {
+    switch (op) {
+        case WOp::add: return a + b;
+        case WOp::sub: return a - b;
+        case WOp::mul: return a * b;
+        case WOp::shl: return a * (R(1) << b);
+    }
+    THORIN_UNREACHABLE;
+}
+
+/// Compares FoldWOp<op>::Fold<w, nsw, nuw> against @p exact.
+template<WOp op, int w, bool nsw, bool nuw>
+::testing::AssertionResult check_wfold(u64 a, u64 b) {
+    typedef typename w2u<w>::type UT;
+    typedef typename w2s<w>::type ST;
+    UT x = a, y = b;
+
+    bool expected_bottom = op == WOp::shl && y >= w;
+    u128 u = 0;
+    if (!expected_bottom) {
+        u = exact<u128>(op, x, y);
+        auto s = exact<s128>(op, ST(x), op == WOp::shl ? s128(y) : s128(ST(y)));
+        expected_bottom = (nuw && u > std::numeric_limits<UT>::max())
+                       || (nsw && (s < std::numeric_limits<ST>::min() || s > std::numeric_limits<ST>::max()));
+    }
+
+    try {
+        auto res = FoldWOp<op>::template Fold<w, nsw, nuw>::run(Box(x), Box(y)).template get<UT>();
+        if (expected_bottom)
+            return ::testing::AssertionFailure() << op2str(op) << ' ' << a << ", " << b << " should be bottom";
+        if (res != UT(u))
+            return ::testing::AssertionFailure() << op2str(op) << ' ' << a << ", " << b << " yields " << u64(res);
+    } catch (BottomException) {
+        if (!expected_bottom)
+            return ::testing::AssertionFailure() << op2str(op) << ' ' << a << ", " << b << " should not be bottom";
+    }
+    return ::testing::AssertionSuccess();
+}
+
+template<int w>
+::testing::AssertionResult check_wfold(u64 a, u64 b) {
+    ::testing::AssertionResult result = ::testing::AssertionSuccess();
+#define CODE(T, o)                                                  \
+    if (result) result = check_wfold<T::o, w, false, false>(a, b);  \
+    if (result) result = check_wfold<T::o, w,  true, false>(a, b);  \
+    if (result) result = check_wfold<T::o, w, false,  true>(a, b);  \
+    if (result) result = check_wfold<T::o, w,  true,  true>(a, b);
+    THORIN_W_OP(CODE)
+#undef CODE
+    return result;
+}
+
+TEST(Fold, WOpExhaustive8) {
+    for (u64 a = 0; a != 256; ++a) {
+        for (u64 b = 0; b != 256; ++b)
+            ASSERT_TRUE(check_wfold<8>(a, b));
+    }
+}
+
+template<int w>
+void test_wfold_sampled() {
+    typedef typename w2u<w>::type UT;
+    typedef typename w2s<w>::type ST;
+    std::vector<u64> edges;
+    for (u64 i = 0; i != w + 2; ++i)
+        edges.emplace_back(i);
+    for (u64 v : {u64(std::numeric_limits<UT>::max()), u64(UT(std::numeric_limits<ST>::max())), u64(UT(std::numeric_limits<ST>::min()))}) {
+        for (u64 d = 0; d != 3; ++d) {
+            edges.emplace_back(UT(v + d));
+            edges.emplace_back(UT(v - d));
+        }
+    }
+
+    for (auto a : edges) {
+        for (auto b : edges)
+            ASSERT_TRUE(check_wfold<w>(a, b));
+    }
+
+    std::mt19937_64 rng(w);
+    for (int i = 0; i != 1 << 14; ++i) {
+        // also draw small operands such that not everything overflows
+        auto draw = [&] { auto r = rng(); return UT(r >> (r % w)); };
+        ASSERT_TRUE(check_wfold<w>(draw(), draw()));
+    }
+}
+
+TEST(Fold, WOpSampled16) { test_wfold_sampled<16>(); }
+TEST(Fold, WOpSampled32) { test_wfold_sampled<32>(); }
+TEST(Fold, WOpSampled64) { test_wfold_sampled<64>(); }
+
+TEST(Fold, F16) {
+    auto run = [](auto fold, f16 a, f16 b) { return fold(Box(a), Box(b)).template get<f16>(); };
+    for (int a = -64; a != 64; ++a) {
+        for (int b = -64; b != 64; ++b) {
+            f16 x = f16(a / 4.f), y = f16(b / 8.f);
+            // all of these are exact in half precision
+            EXPECT_EQ(run(FoldFOp<FOp::fadd>::Fold<16>::run, x, y), f16(float(x) + float(y)));
+            EXPECT_EQ(run(FoldFOp<FOp::fsub>::Fold<16>::run, x, y), f16(float(x) - float(y)));
+            EXPECT_EQ(run(FoldFOp<FOp::fmul>::Fold<16>::run, x, y), f16(float(x) * float(y)));
+        }
+    }
+
+    // rounds to half precision
+    EXPECT_EQ(run(FoldFOp<FOp::fadd>::Fold<16>::run, f16(2048.f), f16(1.f)), f16(2048.f));
+    f16 nan = std::numeric_limits<f16>::quiet_NaN();
+    EXPECT_TRUE(FoldFCmp<FCmp::u>::Fold<16>::run(Box(nan), Box(f16(1.f))).get_bool());
+}
+
+}
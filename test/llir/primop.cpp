@@ -50,6 +50,35 @@ TEST(Primop, ConstFolding) {
     EXPECT_EQ(w.op<IOp::lshr>(w.lit_i(u8(-1)), w.lit_i(1_u8)), w.lit_i(127_u8));
 
     EXPECT_EQ(w.op<WOp::add>(WFlags::nuw, w.lit_i(0xff_u8), w.lit_i(1_u8)), w.bot(w.type_i(8)));
+    EXPECT_EQ(w.op<WOp::add>(WFlags::nsw, w.lit_i(0x7f_u8), w.lit_i(1_u8)), w.bot(w.type_i(8)));
+    EXPECT_EQ(w.op<WOp::sub>(WFlags::nuw, w.lit_i(0_u32), w.lit_i(1_u32)), w.bot(w.type_i(32)));
+    EXPECT_EQ(w.op<WOp::mul>(WFlags::nsw, w.lit_i(s64(-1)), w.lit_i(std::numeric_limits<s64>::min())), w.bot(w.type_i(64)));
+    EXPECT_EQ(w.op<WOp::shl>(w.lit_i(1_u16), w.lit_i(16_u16)), w.bot(w.type_i(16)));
+
+    // overflow is detected per lane of vector shapes
+    auto v = w.op<WOp::add>(WFlags::nsw, w.tuple({w.lit_i(0x7f_u8), w.lit_i(1_u8)}), w.pack(2, w.lit_i(2_u8)));
+    EXPECT_EQ(v, w.tuple({w.bot(w.type_i(8)), w.lit_i(3_u8)}));
+
+    // f16 folds with half precision
+    EXPECT_EQ(w.op<FOp::fadd>(w.lit_f(f16(2048.f)), w.lit_f(f16(1.f))), w.lit_f(f16(2048.f)));
+}
+
+TEST(Primop, FoldKernel) {
+    World w;
+    auto head = [&](WFlags flags) {
+        return w.app(w.app(w.op<WOp::add>(), {w.lit_nat(s64(flags)), w.lit_nat(8)}), w.lit_arity(1))->as<App>();
+    };
+    EXPECT_EQ(head(WFlags::nuw)->fold(), nullptr);
+    EXPECT_EQ(w.op<WOp::add>(WFlags::nuw, w.lit_i(0xff_u8), w.lit_i(1_u8)), w.bot(w.type_i(8)));
+
+    // the kernel is cached in the op-head and reused by subsequent folds
+    auto fold = head(WFlags::nuw)->fold();
+    ASSERT_NE(fold, nullptr);
+    EXPECT_EQ(w.op<WOp::add>(WFlags::nuw, w.lit_i(23_u8), w.lit_i(42_u8)), w.lit_i(65_u8));
+    EXPECT_EQ(head(WFlags::nuw)->fold(), fold);
+
+    EXPECT_EQ(w.op<WOp::add>(w.lit_i(0xff_u8), w.lit_i(1_u8)), w.lit_i(0_u8));
+    EXPECT_NE(head(WFlags::none)->fold(), fold);
 }
 
 template<class T>
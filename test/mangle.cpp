@@ -0,0 +1,63 @@
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "thorin/llir/world.h"
+#include "thorin/transform/mangle.h"
+#include "thorin/fe/parser.h"
+
+#include "test/helpers.h"
+
+namespace thorin::llir {
+
+/**
+ * k(x, y, r) = h(((x * y) + x) * y ...) with @p n operations.
+ * The nominal helper h(z) = r((z + x) + inv) mixes in the argument-independent @p inv.
+ */
+static Lambda* make_kernel(World& w, size_t n, const Def* inv) {
+    auto [k, cur] = make_chain_kernel(w, n);
+    auto h = w.lambda(fe::parse(w, "cn[int 32s64::nat]")->as<Pi>(), {"h"});
+    k->jump(h, cur);
+    h->jump(k->param(2, {"r"}), w.op<WOp::add>(w.op<WOp::add>(h->param({"z"}), k->param(0)), inv));
+    return k;
+}
+
+TEST(Mangle, Batch) {
+    World w;
+    auto inv = w.op<WOp::mul>(w.axiom(w.type_i(32), {"a"}), w.axiom(w.type_i(32), {"b"}));
+    auto k = make_kernel(w, 8, inv);
+    auto y = w.axiom(w.type_i(32), {"y"});
+    auto r = w.axiom(fe::parse(w, "cn int 32s64::nat"), {"r"});
+
+    Scope scope(k);
+    BatchMangler batch(scope);
+
+    for (size_t i = 0; i != 4; ++i) {
+        auto x = w.axiom(w.type_i(32), {"c" + std::to_string(i)});
+        auto single = drop(k, {x, y, r});
+        auto batched = batch.drop({x, y, r});
+        EXPECT_NE(single, batched);
+
+        // the nominal helper is cloned per specialization - so compare the structure behind it
+        auto single_call  = single ->body()->as<App>();
+        auto batched_call = batched->body()->as<App>();
+        EXPECT_EQ(single_call->arg(), batched_call->arg());
+        auto single_h  = single_call ->callee()->as<Lambda>();
+        auto batched_h = batched_call->callee()->as<Lambda>();
+        EXPECT_NE(single_h, batched_h);
+        EXPECT_EQ(single_h->type(), batched_h->type());
+
+        // the helper's body refers to x and the reused inv
+        for (auto h : {single_h, batched_h}) {
+            auto ret = h->body()->as<App>();
+            EXPECT_EQ(ret->callee(), r);
+            EXPECT_EQ(ret->arg(), w.op<WOp::add>(w.op<WOp::add>(h->param(), x), inv));
+        }
+    }
+
+    // keep y
+    auto partial = batch.drop({w.axiom(w.type_i(32), {"c23"}), nullptr, r});
+    EXPECT_EQ(partial->domain(), w.type_i(32));
+}
+
+}
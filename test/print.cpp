@@ -0,0 +1,122 @@
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "thorin/print.h"
+#include "thorin/llir/world.h"
+#include "thorin/fe/parser.h"
+
+namespace thorin {
+
+static std::string make_module(size_t num) {
+    std::ostringstream oss;
+    oss << "g :: Π*.* := λt.t;\n";
+    for (size_t i = 0; i != num; ++i)
+        oss << "f" << i << " :: Π*.[*, *] := λt.(" << (i == 0 ? "g" : "f" + std::to_string(i - 1)) << " t, t);\n";
+    return oss.str();
+}
+
+template<class T>
+static std::string print_def_printer(const T* def) {
+    std::ostringstream oss;
+    DefPrinter printer(oss);
+    printer.recurse(def);
+    return oss.str();
+}
+
+template<class T>
+static std::string print_def_writer(const T* def) {
+    std::ostringstream oss;
+    DefWriter(&oss).recurse(def);
+    return oss.str();
+}
+
+TEST(Print, Module) {
+    World w;
+    fe::parse_module(w, make_module(10));
+    auto f9 = w.lookup_external("f9")->as<Lambda>();
+    auto str = print_def_writer(f9);
+    EXPECT_EQ(str, print_def_printer(f9));
+    EXPECT_NE(str.find("f0_"), std::string::npos);
+    EXPECT_EQ(print_def_writer(f9->body()), print_def_printer(f9->body()));
+}
+
+TEST(Print, AllTags) {
+    World w;
+    auto N = w.type_nat();
+    auto B = w.type_bool();
+    fe::parse_module(w, "f :: Πnat.nat := λn.n;");
+    auto f = w.lookup_external("f")->as<Lambda>();
+    auto n = w.axiom(N, {"n"});
+    auto p = w.axiom(w.sigma({N, B}), {"p"});
+    auto variant = w.variant(w.kind_star(), {N, B});
+    auto intersection = w.intersection(w.kind_star(), {w.pi(N, N), w.pi(B, B)});
+    auto handlers = {w.lambda(N, w.var(N, 0)), w.lambda(B, w.lit_nat(0))};
+
+    std::vector<const Def*> defs = {
+        w.universe(), w.kind_arity(), w.kind_multi(), w.kind_star(w.lit(Qualifier::l)),
+        w.app(f, n), f, f->param(), w.pi(N, N), w.cn(N),
+        w.extract(p, 0_u64), w.insert(p, 0_u64, n), w.tuple({n, p}), w.pack(2, n), w.sigma({N, B}), w.variadic(3, N),
+        w.match(w.axiom(variant, {"v"}), handlers), variant,
+        w.pick(w.pi(N, N), w.axiom(intersection, {"i"})), intersection,
+        w.lit_nat(23), N,
+        w.bot(w.kind_star()), w.top(w.kind_star()),
+        w.singleton(n),
+        w.unknown(),
+        w.var(N, 0),
+    };
+
+    std::vector<bool> tags(size_t(Def::Tag::Num));
+    for (auto def : defs) {
+        tags[size_t(def->tag())] = true;
+
+        std::ostringstream oss;
+        DefPrinter printer(oss);
+        def->stream(printer);
+        DefWriter writer(nullptr);
+        writer.stream(def);
+        EXPECT_EQ(oss.str(), writer.buffer());
+        if (!def->isa<Universe>() && !def->isa<Unknown>()) { // have no type
+            EXPECT_EQ(print_def_printer(def), print_def_writer(def));
+        }
+    }
+    for (size_t i = 0, e = tags.size(); i != e; ++i)
+        EXPECT_TRUE(tags[i]) << "no Def with tag " << i;
+
+    auto str = [](const Def* def) { DefWriter writer(nullptr); writer.stream(def); return writer.buffer(); };
+    EXPECT_EQ(str(defs[10]), "p#0₂ <- n");
+    EXPECT_EQ(str(defs[17]).rfind("pick:", 0), 0u);
+}
+
+TEST(Print, LLIR) {
+    llir::World w;
+    auto k = w.lambda(fe::parse(w, "cn[int 32s64::nat, cn int 32s64::nat]")->as<Pi>(), {"k"});
+    auto x = k->param(0, {"x"});
+    auto t = w.lambda(w.cn(w.unit()), {"t"});
+    auto f = w.lambda(w.cn(w.unit()), {"f"});
+    k->br(w.op<llir::ICmp::ug>(x, w.lit_i(0_u32)), t, f);
+    t->jump(k->param(1, {"r"}), w.op<llir::WOp::add>(x, w.lit_i(42_u32)));
+    f->jump(k->param(1, {"r"}), w.op<llir::WOp::mul>(x, x));
+    EXPECT_EQ(print_def_writer(k), print_def_printer(k));
+}
+
+TEST(Print, Parallel) {
+    World w;
+    fe::parse_module(w, make_module(1000));
+    std::vector<const Lambda*> lambdas;
+    for (size_t i = 0; i != 1000; ++i)
+        lambdas.emplace_back(w.lookup_external("f" + std::to_string(i))->as<Lambda>());
+
+    std::ostringstream sequential, parallel;
+    print_lambdas(lambdas, sequential);
+    print_lambdas(lambdas, parallel, 4);
+    EXPECT_EQ(sequential.str(), parallel.str());
+
+    // each lambda is printed on its own: its callee is only referred to
+    std::ostringstream f1;
+    print_lambdas(ArrayRef<const Lambda*>(lambdas).skip_front(1).skip_back(998), f1);
+    EXPECT_EQ(f1.str().find("f0_"), f1.str().rfind("f0_"));
+    EXPECT_EQ(f1.str().find(":= λ"), f1.str().rfind(":= λ"));
+}
+
+}
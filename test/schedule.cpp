@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+
+#include "thorin/llir/world.h"
+#include "thorin/analyses/domtree.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/fe/parser.h"
+
+#include "test/helpers.h"
+
+namespace thorin::llir {
+
+/// Checks that each operand is placed in a dominating Block and before its user if both share a Block.
+static void check(const Schedule& schedule) {
+    auto& scope = schedule.scope();
+    auto& domtree = schedule.cfg().domtree();
+    DefMap<std::pair<const CFNode*, size_t>> placement;
+    size_t num = 0;
+
+    for (auto& block : schedule) {
+        size_t i = 0;
+        for (auto def : block)
+            placement[def] = {block.node(), i++};
+        num += i;
+    }
+    EXPECT_LE(num, scope.defs().size());
+
+    for (auto [def, place] : placement) {
+        if (auto param = def->isa<Param>()) {
+            EXPECT_TRUE(domtree.dominates(schedule.cfg()[param->lambda()], place.first));
+            continue;
+        }
+
+        for (auto op : def->ops()) {
+            if (op == nullptr || !scope.contains(op) || op->isa_lambda()) continue;
+            auto [op_node, op_i] = placement.find(op)->second;
+            EXPECT_TRUE(domtree.dominates(op_node, place.first));
+            if (op_node == place.first) {
+                EXPECT_LT(op_i, place.second);
+            }
+        }
+    }
+}
+
+TEST(Schedule, Diamond) {
+    World w;
+    auto C = w.cn(w.unit());
+    auto k = w.lambda(fe::parse(w, "cn[int 32s64::nat, cn int 32s64::nat]")->as<Pi>(), {"k"});
+    auto x = k->param(0, {"x"});
+    auto r = k->param(1, {"r"});
+    auto t = w.lambda(C, {"t"});
+    auto f = w.lambda(C, {"f"});
+    auto n = w.lambda(fe::parse(w, "cn[int 32s64::nat, int 32s64::nat]")->as<Pi>(), {"n"});
+    auto a = w.op<WOp::add>(x, w.lit_i(1_u32));
+    auto b = w.op<WOp::mul>(x, w.lit_i(3_u32));
+    k->br(w.op<ICmp::ug>(x, w.lit_i(0_u32)), t, f);
+    t->jump(n, {a, x});
+    f->jump(n, {a, b});
+    n->jump(r, n->param(0, {"res"}));
+    w.make_external(k);
+
+    Scope scope(k);
+    auto& cfg = scope.f_cfg();
+    auto early = schedule(scope, Schedule::Early);
+    auto late  = schedule(scope, Schedule::Late);
+    auto smart = schedule(scope, Schedule::Smart);
+    check(early);
+    check(late);
+    check(smart);
+
+    auto block_of = [&](const Schedule& schedule, const Def* def) -> const CFNode* {
+        for (auto& block : schedule) {
+            for (auto d : block) {
+                if (d == def) return block.node();
+            }
+        }
+        return nullptr;
+    };
+
+    EXPECT_EQ(block_of(early, b), cfg[k]);
+    EXPECT_EQ(block_of(late,  b), cfg[f]);
+    EXPECT_EQ(block_of(late,  a), cfg[k]);
+}
+
+TEST(Schedule, GCM) {
+    World w;
+    auto C = w.cn(w.unit());
+    auto k = w.lambda(fe::parse(w, "cn[int 32s64::nat, cn int 32s64::nat]")->as<Pi>(), {"k"});
+    auto x = k->param(0, {"x"});
+    auto r = k->param(1, {"r"});
+    auto head = w.lambda(fe::parse(w, "cn[int 32s64::nat]")->as<Pi>(), {"head"});
+    auto body = w.lambda(C, {"body"});
+    auto exit = w.lambda(C, {"exit"});
+    auto i = head->param({"i"});
+    auto inv = w.op<WOp::mul>(x, w.lit_i(3_u32));
+    auto cheap = w.op<WOp::add>(x, w.lit_i(7_u32));
+    auto j = w.op<WOp::sub>(i, inv);
+    k->jump(head, w.lit_i(0_u32));
+    head->br(w.op<ICmp::ul>(i, x), body, exit);
+    body->jump(head, j);
+    exit->jump(r, cheap);
+    w.make_external(k);
+
+    Scope scope(k);
+    auto& cfg = scope.f_cfg();
+    auto block_of = [&](const Schedule& schedule, const Def* def) -> const CFNode* {
+        for (auto& block : schedule) {
+            for (auto d : block) {
+                if (d == def) return block.node();
+            }
+        }
+        return nullptr;
+    };
+
+    auto gcm = schedule(scope, Schedule::GCM);
+    check(gcm);
+    EXPECT_EQ(block_of(gcm, inv), cfg[k]);       // hoisted out of the loop
+    EXPECT_EQ(block_of(gcm, j), cfg[body]);
+    EXPECT_EQ(block_of(gcm, cheap), cfg[exit]);  // sunk into the only branch using it
+
+    auto costs = CostTable().set(w.op<WOp::mul>(), 0).set(w.op_load(), 10);
+    EXPECT_EQ(costs[inv], 0u);
+    EXPECT_EQ(costs[j], 1u);
+    EXPECT_EQ(costs[x], 0u);
+
+    auto cheap_mul = schedule(scope, Schedule::GCM, costs);
+    check(cheap_mul);
+    EXPECT_EQ(block_of(cheap_mul, inv), cfg[body]); // not worth hoisting
+}
+
+TEST(Schedule, Linear) {
+    World w;
+    auto k = make_chain(w, 1000);
+
+    Scope scope(k);
+    check(schedule(scope, Schedule::Smart));
+}
+
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+
+#include "thorin/llir/world.h"
+#include "thorin/analyses/scope.h"
+
+#include "test/helpers.h"
+
+namespace thorin::llir {
+
+/// The former hash set based construction of a Scope - serves as reference and baseline.
+static std::pair<DefSet, DefSet> hashed_scope(Lambda* entry) {
+    DefSet defs, free;
+    std::queue<const Def*> queue;
+
+    auto enqueue = [&] (const Def* def) {
+        if (defs.emplace(def).second)
+            queue.push(def);
+    };
+
+    enqueue(entry);
+    enqueue(entry->param());
+
+    while (!queue.empty()) {
+        auto def = pop(queue);
+        if (def != entry) {
+            for (auto use : def->uses())
+                enqueue(use);
+        }
+    }
+
+    enqueue(entry->world().cn_end());
+
+    for (auto def : defs) {
+        for (auto op : def->ops()) {
+            if (op != nullptr && !defs.contains(op))
+                free.emplace(op);
+        }
+    }
+
+    return {defs, free};
+}
+
+TEST(Scope, Free) {
+    World w;
+    auto k = make_chain(w, 16);
+    Scope scope(k);
+    auto [defs, free] = hashed_scope(k);
+
+    EXPECT_EQ(scope.defs().size(), defs.size());
+    for (auto def : scope.defs())
+        EXPECT_TRUE(defs.contains(def));
+    EXPECT_EQ(scope.free().size(), free.size());
+    for (auto def : scope.free()) {
+        EXPECT_TRUE(free.contains(def));
+        EXPECT_TRUE(scope.is_free(def));
+        EXPECT_FALSE(scope.contains(def));
+    }
+    EXPECT_EQ(scope.defs().front(), k);
+
+    scope.update();
+    EXPECT_EQ(scope.defs().size(), defs.size());
+    EXPECT_EQ(scope.free().size(), free.size());
+}
+
+TEST(Scope, Nested) {
+    World w;
+    auto k1 = make_chain(w, 16);
+    auto k2 = w.lambda(k1->type(), {"k2"});
+    k2->jump(k1, w.tuple({w.op<WOp::mul>(k2->param(0), k2->param(1)), k2->param(1), k2->param(2)}));
+
+    auto check = [](const Scope& scope, Lambda* k) {
+        auto [defs, free] = hashed_scope(k);
+        for (auto def : defs) {
+            ASSERT_TRUE(scope.contains(def));
+            EXPECT_EQ(scope.defs()[scope.index(def)], def);
+        }
+        for (auto def : free)
+            EXPECT_TRUE(scope.is_free(def));
+    };
+
+    Scope a(k1);
+    {
+        Scope b(k2);
+        check(b, k2);
+        EXPECT_FALSE(b.contains(k1));
+    }
+    check(a, k1); // b has handed back the marks
+
+    auto b = std::make_unique<Scope>(k2);
+    check(a, k1); // a remarks its Defs
+    check(*b, k2);
+    EXPECT_EQ(a.index(k2), Scope::None);
+    b.reset();
+    check(a, k1);
+}
+
+TEST(Scope, Large) {
+    World w;
+    auto k = make_chain(w, 10000);
+    auto [defs, free] = hashed_scope(k);
+    Scope scope(k);
+
+    EXPECT_EQ(scope.defs().size(), defs.size());
+    EXPECT_EQ(scope.free().size(), free.size());
+}
+
+}
@@ -0,0 +1,157 @@
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "thorin/serialize.h"
+#include "thorin/llir/world.h"
+#include "thorin/fe/parser.h"
+
+namespace thorin {
+
+static std::string to_binary(const World& world) {
+    std::ostringstream oss;
+    serialize(world, oss);
+    return oss.str();
+}
+
+static std::string make_module(size_t num) {
+    std::ostringstream oss;
+    oss << "K = *;\n";
+    oss << "g :: Π*.* := λt.t;\n";
+    for (size_t i = 0; i != num; ++i)
+        oss << "f" << i << " :: Π*.[K, *] := λt.(" << (i == 0 ? "g" : "f" + std::to_string(i - 1)) << " t, t);\n";
+    return oss.str();
+}
+
+TEST(Serialize, Module) {
+    World w;
+    fe::parse_module(w, make_module(10));
+    auto binary = to_binary(w);
+
+    for (bool check : {false, true}) {
+        World v;
+        deserialize(v, binary, check);
+        EXPECT_EQ(v.externals().size(), w.externals().size());
+        for (auto [name, def] : w.externals()) {
+            auto l1 = def->as<Lambda>();
+            auto l2 = v.lookup_external(name)->as<Lambda>();
+            EXPECT_TRUE(l2->is_nominal());
+            EXPECT_EQ(l2->type(), v.pi(v.kind_star(), name == "g" ? v.kind_star() : v.sigma({v.kind_star(), v.kind_star()})));
+            EXPECT_STREQ(l2->loc().filename(), l1->loc().filename());
+            EXPECT_EQ(l2->loc().front_line(), l1->loc().front_line());
+            EXPECT_EQ(l2->loc().back_col(), l1->loc().back_col());
+            EXPECT_EQ(l1->body()->tag(), l2->body()->tag());
+        }
+        auto f1 = v.lookup_external("f1")->as<Lambda>();
+        EXPECT_EQ(v.extract(f1->body(), 0_u64)->as<App>()->callee(), v.lookup_external("f0"));
+        EXPECT_EQ(v.extract(f1->body(), 1_u64), f1->param());
+
+        // writing the loaded World again yields the very same bytes
+        if (!check) {
+            EXPECT_EQ(to_binary(v), binary);
+        }
+    }
+
+    World v;
+    EXPECT_THROW(deserialize(v, "garbage"), std::runtime_error);
+    EXPECT_THROW(deserialize(v, binary.substr(0, binary.size() / 2)), std::runtime_error);
+}
+
+TEST(Serialize, LLIR) {
+    llir::World w;
+    auto k = w.lambda(fe::parse(w, "cn[int 32s64::nat, cn int 32s64::nat]")->as<Pi>(), {"k"});
+    auto x = k->param(0, {"x"});
+    auto t = w.lambda(w.cn(w.unit()), {"t"});
+    auto sum = w.op<llir::WOp::add>(x, w.lit_i(42_u32));
+    k->br(w.op<llir::ICmp::ug>(x, w.lit_i(0_u32)), t, w.cn_end());
+    t->jump(k->param(1, {"r"}), sum);
+    w.make_external(k);
+
+    for (bool check : {false, true}) {
+        llir::World v;
+        deserialize(v, to_binary(w), check);
+        auto l = v.lookup_external("k")->as<Lambda>();
+        EXPECT_EQ(l->type(), fe::parse(v, "cn[int 32s64::nat, cn int 32s64::nat]"));
+        auto add = v.op<llir::WOp::add>(l->param(0), v.lit_i(42_u32));
+        auto br = l->body()->as<App>();
+        auto branches = br->arg()->ops().skip_front(1);
+        EXPECT_EQ(branches[1], v.cn_end());
+        auto jump = branches[0]->as<Lambda>()->body()->as<App>();
+        EXPECT_EQ(jump->arg(), add); // hash-consed with the op built via v
+        EXPECT_EQ(jump->callee(), l->param(1));
+    }
+}
+
+TEST(Serialize, Snapshot) {
+    std::string filename = "serialize_snapshot.thorin.bin";
+    {
+        World w;
+        fe::parse_module(w, make_module(1000));
+        serialize_file(w, filename.c_str());
+    }
+
+    World w;
+    Snapshot snapshot(w, filename.c_str());
+    EXPECT_EQ(snapshot.num_externals(), 1001u);
+    EXPECT_EQ(snapshot.num_materialized(), 0u);
+    EXPECT_EQ(snapshot.lookup_external("nope"), nullptr);
+    EXPECT_EQ(snapshot.lookup_axiom("nope"), nullptr);
+
+    auto f5 = snapshot.lookup_external("f5")->as<Lambda>();
+    EXPECT_EQ(w.lookup_external("f5"), f5);
+    EXPECT_TRUE(snapshot.is_expanded(f5));
+    EXPECT_LT(snapshot.num_materialized(), 20u);
+    EXPECT_LT(snapshot.num_materialized() * 100, snapshot.num_defs());
+
+    // the callee is only a stub so far
+    auto f4 = w.extract(f5->body(), 0_u64)->as<App>()->callee()->as<Lambda>();
+    EXPECT_EQ(f4->name(), "f4");
+    EXPECT_FALSE(snapshot.is_expanded(f4));
+    EXPECT_EQ(f4->body(), nullptr);
+    EXPECT_EQ(snapshot.expand(f4), f4);
+    EXPECT_TRUE(snapshot.is_expanded(f4));
+    EXPECT_EQ(w.extract(f4->body(), 1_u64), f4->param());
+    EXPECT_EQ(snapshot.lookup_external("f4"), f4);
+
+    snapshot.materialize();
+    EXPECT_EQ(snapshot.num_materialized(), snapshot.num_defs());
+    EXPECT_EQ(w.externals().size(), 1001u);
+    std::remove(filename.c_str());
+
+    EXPECT_THROW(Snapshot(w, filename.c_str()), std::runtime_error);
+}
+
+TEST(Serialize, SnapshotAxioms) {
+    llir::World w;
+    auto k = w.lambda(fe::parse(w, "cn[int 32s64::nat, cn int 32s64::nat]")->as<Pi>(), {"k"});
+    k->jump(k->param(1), w.op<llir::WOp::add>(k->param(0), k->param(0)));
+    w.make_external(k);
+    std::ostringstream oss;
+    serialize(w, oss);
+    auto binary = oss.str();
+
+    llir::World v;
+    Snapshot snapshot(v, binary);
+    EXPECT_EQ(snapshot.lookup_axiom("int"), v.lookup_axiom("int"));
+    auto l = snapshot.lookup_external("k")->as<Lambda>();
+    EXPECT_EQ(l->body()->as<App>()->arg(), v.op<llir::WOp::add>(l->param(0), l->param(0)));
+}
+
+TEST(Serialize, Large) {
+    World parsed;
+    fe::parse_module(parsed, make_module(1000));
+    auto binary = to_binary(parsed);
+    World unchecked;
+    deserialize(unchecked, binary);
+    World checked;
+    deserialize(checked, binary, true);
+    World lazy;
+    Snapshot snapshot(lazy, binary);
+
+    EXPECT_EQ(unchecked.externals().size(), parsed.externals().size());
+    EXPECT_EQ(checked.externals().size(), parsed.externals().size());
+    EXPECT_TRUE(snapshot.lookup_external("f500") != nullptr);
+    EXPECT_LT(snapshot.num_materialized(), snapshot.num_defs());
+}
+
+}
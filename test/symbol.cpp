@@ -0,0 +1,60 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "thorin/util/symbol.h"
+
+namespace thorin {
+
+TEST(Symbol, Intern) {
+    Symbol empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_FALSE(empty);
+    EXPECT_EQ(empty, Symbol(""));
+    EXPECT_EQ(empty.size(), 0u);
+
+    Symbol a("symbol_intern_a");
+    std::string str = "symbol_intern_";
+    str += "a";
+    EXPECT_EQ(a, Symbol(str));
+    EXPECT_EQ(a.c_str(), Symbol(std::string_view(str)).c_str());
+    EXPECT_EQ(a.view(), "symbol_intern_a");
+    EXPECT_EQ(a.size(), 15u);
+    EXPECT_EQ(a.hash(), hash("symbol_intern_a"));
+    EXPECT_TRUE(a == "symbol_intern_a");
+    EXPECT_TRUE(a != "symbol_intern_b");
+    EXPECT_TRUE(a != "symbol_intern_");
+
+    // comparing against or looking up a string does not intern it
+    auto num = Symbol::num();
+    EXPECT_FALSE(a == "symbol_intern_never_interned");
+    EXPECT_FALSE(Symbol::lookup("symbol_intern_never_interned"));
+    EXPECT_EQ(Symbol::num(), num);
+    EXPECT_EQ(*Symbol::lookup("symbol_intern_a"), a);
+
+    std::string big(100000, 'x');
+    EXPECT_EQ(Symbol(big).view(), big);
+}
+
+TEST(Symbol, Concurrent) {
+    size_t num_threads = 4, num = 10000;
+    std::vector<std::vector<Symbol>> symbols(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t != num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i != num; ++i)
+                symbols[t].emplace_back("symbol_concurrent_" + std::to_string(i));
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t t = 1; t != num_threads; ++t) {
+        for (size_t i = 0; i != num; ++i)
+            EXPECT_EQ(symbols[0][i].c_str(), symbols[t][i].c_str());
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+#include <sstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "thorin/llir/world.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/util/log.h"
+#include "thorin/util/trace.h"
+
+namespace thorin {
+
+static size_t count(const std::string& str, const std::string& pattern) {
+    size_t n = 0;
+    for (auto i = str.find(pattern); i != std::string::npos; i = str.find(pattern, i + 1))
+        ++n;
+    return n;
+}
+
+TEST(Trace, Spans) {
+    auto enabled = Trace::enabled();
+    Trace::clear();
+    Trace::enable();
+
+    llir::World w;
+    auto f = w.lambda(w.cn(w.unit()), {"f"});
+    f->jump(f, w.val_unit());
+    Scope scope(f);
+    {
+        THORIN_TRACE("outer \"span\"");
+    }
+    auto& stream = Log::stream();
+    auto min_level = Log::min_level();
+    std::ostringstream log;
+    Log::set_stream(log);
+    Log::set_min_level(Log::Info);
+    ILOG("hello {}", 23);
+    Log::set_stream(stream);
+    Log::set_min_level(min_level);
+    EXPECT_EQ(log.str().find("hello 23"), log.str().size() - 9);
+
+    std::ostringstream oss;
+    Trace::flush(oss);
+    Trace::clear();
+    Trace::enable(enabled);
+
+    auto json = oss.str();
+    EXPECT_EQ(json.find("{\"traceEvents\": ["), 0u);
+    EXPECT_GE(count(json, "\"name\": \"World::World(prelude)\", \"ph\": \"X\""), 1u);
+    EXPECT_EQ(count(json, "\"name\": \"Scope\", \"ph\": \"X\""), 1u);
+    EXPECT_EQ(count(json, "\"name\": \"outer \\\"span\\\"\", \"ph\": \"X\""), 1u);
+    EXPECT_EQ(count(json, "\"name\": \"hello 23\", \"ph\": \"i\""), 1u);
+}
+
+TEST(Trace, Threads) {
+    auto enabled = Trace::enabled();
+    Trace::clear();
+    Trace::enable();
+
+    std::thread([] { THORIN_TRACE("thread A"); }).join();
+    std::thread([] { THORIN_TRACE("thread B"); }).join();
+    Trace::enable(false);
+    { THORIN_TRACE("disabled"); }
+
+    std::ostringstream oss;
+    Trace::flush(oss);
+    Trace::clear();
+    Trace::enable(enabled);
+
+    auto json = oss.str();
+    auto a = json.find("\"thread A\""), b = json.find("\"thread B\"");
+    ASSERT_NE(a, std::string::npos);
+    ASSERT_NE(b, std::string::npos);
+    EXPECT_EQ(json.find("\"disabled\""), std::string::npos);
+    auto tid = [&](size_t i) { return json.substr(json.find("\"tid\": ", i), json.find('}', i) - json.find("\"tid\": ", i)); };
+    EXPECT_NE(tid(a), tid(b));
+}
+
+}
@@ -0,0 +1,127 @@
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "thorin/llir/world.h"
+#include "thorin/fe/parser.h"
+
+namespace thorin {
+
+TEST(World, Prelude) {
+    auto& prelude = World::prelude();
+    World w(prelude, {});
+
+    EXPECT_EQ(w.defs().size(), prelude.defs().size());
+    EXPECT_EQ(&w.type_bool()->world(), &w);
+    EXPECT_EQ(w.lookup_axiom("bool"), w.type_bool());
+    EXPECT_EQ(w.kind(Def::Tag::KindStar, w.lit(Qualifier::u)), w.kind_star());
+    EXPECT_EQ(w.lit_nat(4), w.lit_nat_4());
+    EXPECT_EQ(w.lit_arity(1), w.unit());
+    EXPECT_EQ(w.op<NOp::nadd>(w.lit_nat(2), w.lit_nat(3)), w.lit_nat(5));
+    EXPECT_EQ(fe::parse(w, "Πnat. bool"), w.pi(w.type_nat(), w.type_bool()));
+    EXPECT_EQ(w.cn_end()->body(), nullptr);
+    for (auto q : Qualifiers) {
+        EXPECT_EQ(&w.unit_kind(q)->world(), &w);
+        EXPECT_EQ(w.unit_kind(q), w.variadic(w.lit_arity(0), w.kind_star(q)));
+        EXPECT_EQ(w.val_unit_kind(q), w.pack(w.lit_arity(0), w.unit(q)));
+    }
+}
+
+TEST(World, PreludeLLIR) {
+    llir::World w(llir::World::prelude(), {});
+
+    EXPECT_EQ(w.defs().size(), llir::World::prelude().defs().size());
+    EXPECT_EQ(fe::parse(w, "int 32s64::nat"), w.type_i(32));
+    EXPECT_EQ(w.op<llir::WOp::add>(w.lit_i(2_u32), w.lit_i(3_u32)), w.lit_i(5_u32));
+    EXPECT_EQ(w.op<llir::Cast::u2u>(), w.lookup_axiom("u2u"));
+}
+
+TEST(World, Merge) {
+    World w1, w2;
+    fe::parse_module(w1, "g :: Π*.* := λt.t;");
+    fe::parse_module(w2, "g :: Π*.*; h :: Π*.[*, *] := λt.(g t, t);");
+    auto num = w1.defs().size();
+    w1.merge(w2);
+
+    EXPECT_EQ(w1.externals().size(), 2u);
+    auto g = w1.lookup_external("g")->as<Lambda>();
+    auto h = w1.lookup_external("h")->as<Lambda>();
+    EXPECT_EQ(h->type()->as<Pi>()->domain(), w1.kind_star());
+    EXPECT_EQ(w1.extract(h->body(), 0_u64)->as<App>()->callee(), g);
+    // only h and its body are new
+    EXPECT_LT(w1.defs().size() - num, 20u);
+}
+
+TEST(World, MergeClash) {
+    {
+        World w1, w2;
+        fe::parse_module(w1, "g :: Π*.* := λt.t;");
+        fe::parse_module(w2, "g :: Π*.* := λt.t;");
+        EXPECT_THROW(w1.merge(w2), TypeError);
+    }
+    {
+        World w1, w2;
+        w1.axiom(w1.type_nat(), {"a"});
+        auto a = w2.axiom(w2.kind_star(), {"a"});
+        auto h = w2.lambda(w2.pi(w2.kind_star(), w2.kind_star()), {"h"})->set(a);
+        w2.make_external(h);
+        EXPECT_THROW(w1.merge(w2), TypeError);
+    }
+}
+
+TEST(World, Stats) {
+    llir::World w;
+    for (int i = 0; i != 2; ++i)
+        w.op<llir::WOp::add>(w.lit_i(23_u32), w.lit_i(42_u32));
+    auto stats = w.stats();
+    std::ostringstream text, json;
+    stats.stream(text);
+    stats.json(json);
+
+    if (!Stats::enabled) {
+        EXPECT_EQ(json.str(), "{\"enabled\": false}\n");
+        return;
+    }
+
+    EXPECT_EQ(stats.num_defs, w.defs().size());
+    EXPECT_GT(stats.nodes[size_t(Def::Tag::Lit)].created, 0u);
+    EXPECT_GT(stats.nodes[size_t(Def::Tag::App)].deduped, 0u);
+    EXPECT_GT(stats.nodes[size_t(Def::Tag::Axiom)].nominals, 100u);
+    auto& add = stats.normalizers.find(w.op<llir::WOp::add>())->second;
+    EXPECT_EQ(add.calls, 2u);
+    EXPECT_EQ(add.hits, 2u);
+    EXPECT_NE(json.str().find("\"add\": {\"calls\": 2, \"hits\": 2}"), std::string::npos);
+    EXPECT_NE(text.str().find("Axiom"), std::string::npos);
+}
+
+TEST(World, DebugTable) {
+    World w;
+    auto size = w.debug_table().size();
+    Loc loc("test.thorin", 1, 2, 3, 4);
+    auto a = w.var(w.type_nat(), 0, {loc, "a"});
+    auto b = w.var(w.type_nat(), 1, {loc, "a"});
+    EXPECT_EQ(&a->debug(), &b->debug());
+    EXPECT_EQ(w.debug_table().size(), size + 1);
+    EXPECT_EQ(a->name(), "a");
+#ifdef THORIN_DROP_DEBUG_LOCS
+    EXPECT_FALSE(a->loc().is_set());
+#else
+    EXPECT_EQ(a->loc(), loc);
+#endif
+
+    // no debug info at all shares handle 0
+    EXPECT_EQ(&w.tuple({a, b})->debug(), &w.tuple({b, a})->debug());
+
+    // a dedup hit keeps the existing Debug and doesn't grow the table
+    size = w.debug_table().size();
+    EXPECT_EQ(w.var(w.type_nat(), 0, {loc, "c"}), a);
+    EXPECT_EQ(w.tuple({a, b}, {"t"}), w.tuple({a, b}));
+    EXPECT_EQ(w.debug_table().size(), size);
+    EXPECT_EQ(a->name(), "a");
+
+    b->set_name("b");
+    EXPECT_EQ(b->name(), "b");
+    EXPECT_EQ(a->name(), "a");
+}
+
+}
@@ -8,9 +8,11 @@
 #include "thorin/analyses/domfrontier.h"
 #include "thorin/analyses/domtree.h"
 #include "thorin/analyses/looptree.h"
+#include "thorin/analyses/manager.h"
 #include "thorin/analyses/scope.h"
 #include "thorin/util/log.h"
 #include "thorin/util/utility.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
@@ -32,6 +34,7 @@ CFA::CFA(const Scope& scope)
     , entry_(node(scope.entry()))
     , exit_ (node(scope.exit() ))
 {
+    THORIN_TRACE("CFA");
     std::queue<Lambda*> cfg_queue;
     LambdaSet cfg_done;
 
@@ -83,8 +86,8 @@ CFA::~CFA() {
         delete p.second;
 }
 
-const F_CFG& CFA::f_cfg() const { return lazy_init(this, f_cfg_); }
-const B_CFG& CFA::b_cfg() const { return lazy_init(this, b_cfg_); }
+const F_CFG& CFA::f_cfg() const { return scope().analyses().cfg<true>(); }
+const B_CFG& CFA::b_cfg() const { return scope().analyses().cfg<false>(); }
 
 void CFA::link_to_exit() {
     typedef thorin::GIDSet<const CFNode*> CFNodeSet;
@@ -166,6 +169,10 @@ CFG<forward>::CFG(const CFA& cfa)
     : cfa_(cfa)
     , rpo_(*this)
 {
+    // the CFA may outlive a previous CFG of the same direction
+    for (const auto& p : cfa.nodes())
+        (forward ? p.second->f_index_ : p.second->b_index_) = size_t(-1);
+
 #ifndef NDEBUG
     assert(post_order_visit(entry(), size()) == 0);
 #else
@@ -190,9 +197,9 @@ size_t CFG<forward>::post_order_visit(const CFNode* n, size_t i) {
 
 template<bool forward> const CFNodes& CFG<forward>::preds(const CFNode* n) const { assert(n != nullptr); return forward ? n->preds() : n->succs(); }
 template<bool forward> const CFNodes& CFG<forward>::succs(const CFNode* n) const { assert(n != nullptr); return forward ? n->succs() : n->preds(); }
-template<bool forward> const DomTreeBase<forward>& CFG<forward>::domtree() const { return lazy_init(this, domtree_); }
-template<bool forward> const LoopTree<forward>& CFG<forward>::looptree() const { return lazy_init(this, looptree_); }
-template<bool forward> const DomFrontierBase<forward>& CFG<forward>::domfrontier() const { return lazy_init(this, domfrontier_); }
+template<bool forward> const DomTreeBase<forward>& CFG<forward>::domtree() const { return cfa().scope().analyses().template domtree<forward>(); }
+template<bool forward> const LoopTree<forward>& CFG<forward>::looptree() const { return cfa().scope().analyses().template looptree<forward>(); }
+template<bool forward> const DomFrontierBase<forward>& CFG<forward>::domfrontier() const { return cfa().scope().analyses().template domfrontier<forward>(); }
 
 template class CFG<true>;
 template class CFG<false>;
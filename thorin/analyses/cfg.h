@@ -83,8 +83,6 @@ private:
     LambdaMap<const CFNode*> nodes_;
     const CFNode* entry_;
     const CFNode* exit_;
-    mutable std::unique_ptr<const F_CFG> f_cfg_;
-    mutable std::unique_ptr<const B_CFG> b_cfg_;
 
     template<bool> friend class CFG;
 };
@@ -141,9 +139,6 @@ private:
 
     const CFA& cfa_;
     Map<const CFNode*> rpo_;
-    mutable std::unique_ptr<const DomTreeBase<forward>> domtree_;
-    mutable std::unique_ptr<const LoopTree<forward>> looptree_;
-    mutable std::unique_ptr<const DomFrontierBase<forward>> domfrontier_;
 };
 
 //------------------------------------------------------------------------------
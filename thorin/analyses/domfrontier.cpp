@@ -1,11 +1,13 @@
 #include "thorin/analyses/domfrontier.h"
 
 #include "thorin/analyses/domtree.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
 template<bool forward>
 void DomFrontierBase<forward>::create() {
+    THORIN_TRACE(forward ? "DomFrontiers" : "ControlDeps");
     const auto& domtree = cfg().domtree();
     for (auto n : cfg().reverse_post_order().skip_front()) {
         const auto& preds = cfg().preds(n);
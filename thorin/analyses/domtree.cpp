@@ -1,9 +1,11 @@
 #include "thorin/analyses/domtree.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
 template<bool forward>
 void DomTreeBase<forward>::create() {
+    THORIN_TRACE(forward ? "DomTree" : "PostDomTree");
     // Cooper et al, 2001. A Simple, Fast Dominance Algorithm. http://www.cs.rice.edu/~keith/EMBED/dom.pdf
 
     // all idoms different from entry are set to their first found dominating pred
@@ -24,7 +26,7 @@ outer_loop:;
         for (auto n : cfg().reverse_post_order().skip_front()) {
             const CFNode* new_idom = nullptr;
             for (auto pred : cfg().preds(n))
-                new_idom = new_idom ? lca(new_idom, pred) : pred;
+                new_idom = new_idom ? climb(new_idom, pred) : pred;
 
             assert(new_idom);
             if (idom(n) != new_idom) {
@@ -39,15 +41,39 @@ outer_loop:;
 }
 
 template<bool forward>
-void DomTreeBase<forward>::depth(const CFNode* n, int i) {
-    depth_[n] = i;
-    for (auto child : children(n))
-        depth(child, i+1);
+void DomTreeBase<forward>::number() {
+    // iterative DFS which assigns depth as well as pre- and post-order numbers
+    std::vector<std::pair<const CFNode*, size_t>> stack;
+    size_t pre = 0, post = 0;
+
+    depth_[root()] = 0;
+    pre_[root()] = pre++;
+    stack.emplace_back(root(), 0);
+
+    while (!stack.empty()) {
+        auto& [n, i] = stack.back();
+        if (i != children(n).size()) {
+            auto child = children(n)[i++];
+            depth_[child] = depth_[n] + 1;
+            pre_[child] = pre++;
+            stack.emplace_back(child, 0);
+        } else {
+            post_[n] = post++;
+            stack.pop_back();
+        }
+    }
 }
 
 template<bool forward>
 const CFNode* DomTreeBase<forward>::lca(const CFNode* i, const CFNode* j) const {
     assert(i && j);
+    if (dominates(i, j)) return i;
+    if (dominates(j, i)) return j;
+    return climb(i, j);
+}
+
+template<bool forward>
+const CFNode* DomTreeBase<forward>::climb(const CFNode* i, const CFNode* j) const {
     while (index(i) != index(j)) {
         while (index(i) < index(j)) j = idom(j);
         while (index(j) < index(i)) i = idom(i);
@@ -22,9 +22,11 @@ public:
         , children_(cfg)
         , idoms_(cfg)
         , depth_(cfg)
+        , pre_(cfg)
+        , post_(cfg)
     {
         create();
-        depth(root(), 0);
+        number();
     }
 
     const CFG<forward>& cfg() const { return cfg_; }
@@ -33,16 +35,25 @@ public:
     const CFNode* root() const { return *idoms_.begin(); }
     const CFNode* idom(const CFNode* n) const { return idoms_[n]; }
     int depth(const CFNode* n) const { return depth_[n]; }
+    /// Pre-order number of @p n in a depth-first traversal of this tree.
+    size_t pre(const CFNode* n) const { return pre_[n]; }
+    /// Post-order number of @p n in a depth-first traversal of this tree.
+    size_t post(const CFNode* n) const { return post_[n]; }
+    /// Does @p i dominate @p j? Answered in constant time via the DFS numbering.
+    bool dominates(const CFNode* i, const CFNode* j) const { return pre(i) <= pre(j) && post(j) <= post(i); }
     const CFNode* lca(const CFNode* i, const CFNode* j) const; ///< Returns the least common ancestor of @p i and @p j.
 
 private:
     void create();
-    void depth(const CFNode* n, int i);
+    void number();
+    const CFNode* climb(const CFNode* i, const CFNode* j) const; ///< @p lca without the DFS numbering - needed while constructing.
 
     const CFG<forward>& cfg_;
     typename CFG<forward>::template Map<std::vector<const CFNode*>> children_;
     typename CFG<forward>::template Map<const CFNode*> idoms_;
     typename CFG<forward>::template Map<int> depth_;
+    typename CFG<forward>::template Map<size_t> pre_;
+    typename CFG<forward>::template Map<size_t> post_;
 };
 
 typedef DomTreeBase<true>  DomTree;
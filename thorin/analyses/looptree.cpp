@@ -5,6 +5,7 @@
 #include <stack>
 
 #include "thorin/analyses/cfg.h"
+#include "thorin/util/trace.h"
 
 /*
  * The implementation is based on Steensgard's algorithm to find loops in irreducible CFGs.
@@ -224,6 +225,7 @@ LoopTree<forward>::LoopTree(const CFG<forward>& cfg)
     : cfg_(cfg)
     , leaves_(cfg)
 {
+    THORIN_TRACE(forward ? "LoopTree" : "LoopTree<false>");
     LoopTreeBuilder<forward>(*this);
 }
 
@@ -0,0 +1,108 @@
+#include "thorin/analyses/manager.h"
+
+namespace thorin {
+
+using Analysis = AnalysisManager::Analysis;
+
+/// Direct dependencies of each @p Analysis - in enum order, which is a topological order of this graph.
+static const std::array<std::vector<Analysis>, AnalysisManager::Num> dependencies = {{
+    /*CFA         */ {},
+    /*F_CFG       */ {Analysis::CFA},
+    /*B_CFG       */ {Analysis::CFA},
+    /*DomTree     */ {Analysis::F_CFG},
+    /*PostDomTree */ {Analysis::B_CFG},
+    /*DomFrontiers*/ {Analysis::F_CFG, Analysis::DomTree},
+    /*ControlDeps */ {Analysis::B_CFG, Analysis::PostDomTree},
+    /*F_LoopTree  */ {Analysis::F_CFG},
+    /*B_LoopTree  */ {Analysis::B_CFG},
+    /*Schedule    */ {Analysis::F_CFG, Analysis::DomTree, Analysis::F_LoopTree},
+}};
+
+AnalysisManager::AnalysisManager(const Scope& scope)
+    : scope_(scope)
+{}
+
+AnalysisManager::~AnalysisManager() { invalidate(); }
+
+const CFA& AnalysisManager::cfa() const { return build(Analysis::CFA, cfa_, scope_); }
+
+const Schedule& AnalysisManager::schedule(Schedule::Tag tag) const {
+    domtree<true>();
+    looptree<true>();
+    return build(Analysis::Schedule, schedules_[tag], scope_, tag);
+}
+
+bool AnalysisManager::is_valid(Analysis a) const {
+    switch (a) {
+        case Analysis::CFA:          return bool(cfa_);
+        case Analysis::F_CFG:        return bool(f_cfg_);
+        case Analysis::B_CFG:        return bool(b_cfg_);
+        case Analysis::DomTree:      return bool(domtree_);
+        case Analysis::PostDomTree:  return bool(postdomtree_);
+        case Analysis::DomFrontiers: return bool(domfrontiers_);
+        case Analysis::ControlDeps:  return bool(controldeps_);
+        case Analysis::F_LoopTree:   return bool(f_looptree_);
+        case Analysis::B_LoopTree:   return bool(b_looptree_);
+        case Analysis::Schedule:
+            return std::any_of(schedules_.begin(), schedules_.end(), [](const auto& schedule) { return bool(schedule); });
+        default: THORIN_UNREACHABLE;
+    }
+}
+
+void AnalysisManager::invalidate(Analysis a) {
+    std::array<bool, Num> dirty = {};
+    dirty[size_t(a)] = true;
+    for (size_t i = size_t(a) + 1; i != Num; ++i) {
+        for (auto dep : dependencies[i])
+            dirty[i] |= dirty[size_t(dep)];
+    }
+
+    // dependents hold references to their dependencies - so tear down in reverse topological order
+    for (size_t i = Num; i-- != 0;) {
+        if (!dirty[i]) continue;
+        switch (Analysis(i)) {
+            case Analysis::CFA:          cfa_          = nullptr; break;
+            case Analysis::F_CFG:        f_cfg_        = nullptr; break;
+            case Analysis::B_CFG:        b_cfg_        = nullptr; break;
+            case Analysis::DomTree:      domtree_      = nullptr; break;
+            case Analysis::PostDomTree:  postdomtree_  = nullptr; break;
+            case Analysis::DomFrontiers: domfrontiers_ = nullptr; break;
+            case Analysis::ControlDeps:  controldeps_  = nullptr; break;
+            case Analysis::F_LoopTree:   f_looptree_   = nullptr; break;
+            case Analysis::B_LoopTree:   b_looptree_   = nullptr; break;
+            case Analysis::Schedule:
+                for (auto& schedule : schedules_)
+                    schedule = nullptr;
+                break;
+            default: THORIN_UNREACHABLE;
+        }
+    }
+}
+
+const char* AnalysisManager::name(Analysis a) {
+    switch (a) {
+        case Analysis::CFA:          return "CFA";
+        case Analysis::F_CFG:        return "F_CFG";
+        case Analysis::B_CFG:        return "B_CFG";
+        case Analysis::DomTree:      return "DomTree";
+        case Analysis::PostDomTree:  return "PostDomTree";
+        case Analysis::DomFrontiers: return "DomFrontiers";
+        case Analysis::ControlDeps:  return "ControlDeps";
+        case Analysis::F_LoopTree:   return "F_LoopTree";
+        case Analysis::B_LoopTree:   return "B_LoopTree";
+        case Analysis::Schedule:     return "Schedule";
+        default: THORIN_UNREACHABLE;
+    }
+}
+
+Printer& AnalysisManager::stream(Printer& p) const {
+    for (size_t i = 0; i != Num; ++i) {
+        auto& s = stats_[i];
+        auto ms = std::chrono::duration<double, std::milli>(s.time).count();
+        if (i != 0) p.endl();
+        streamf(p, "{}: {} builds, {} ms", name(Analysis(i)), s.builds, ms);
+    }
+    return p;
+}
+
+}
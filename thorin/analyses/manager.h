@@ -0,0 +1,122 @@
+#ifndef THORIN_ANALYSES_MANAGER_H
+#define THORIN_ANALYSES_MANAGER_H
+
+#include <array>
+#include <chrono>
+
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/domfrontier.h"
+#include "thorin/analyses/domtree.h"
+#include "thorin/analyses/looptree.h"
+#include "thorin/analyses/schedule.h"
+
+namespace thorin {
+
+/**
+ * Memoizes all analyses of a @p Scope.
+ * Each analysis is built on its first request and kept until it is invalidated - either explicitly via @p invalidate or via @p Scope::update.
+ * Invalidating an analysis also invalidates all analyses depending on it - e.g., invalidating the @p LoopTree drops all @p Schedule%s but keeps the @p DomTree.
+ * Dependencies are built before their dependents such that the recorded build times are exclusive.
+ */
+class AnalysisManager : public Streamable<Printer> {
+public:
+    enum class Analysis : size_t { CFA, F_CFG, B_CFG, DomTree, PostDomTree, DomFrontiers, ControlDeps, F_LoopTree, B_LoopTree, Schedule, Num };
+    static constexpr size_t Num = size_t(Analysis::Num);
+
+    struct Stats {
+        size_t builds = 0;
+        std::chrono::nanoseconds time = std::chrono::nanoseconds::zero();
+    };
+
+    AnalysisManager(const AnalysisManager&) = delete;
+    AnalysisManager& operator=(AnalysisManager) = delete;
+
+    explicit AnalysisManager(const Scope&);
+    ~AnalysisManager();
+
+    const Scope& scope() const { return scope_; }
+
+    //@{ get analyses - built on demand
+    const CFA& cfa() const;
+    template<bool forward> const CFG<forward>& cfg() const;
+    template<bool forward> const DomTreeBase<forward>& domtree() const;
+    template<bool forward> const DomFrontierBase<forward>& domfrontier() const;
+    template<bool forward> const LoopTree<forward>& looptree() const;
+    /// Only @p Schedule%s with the default @p CostTable are memoized.
+    const Schedule& schedule(Schedule::Tag = Schedule::Smart) const;
+    //@}
+
+    //@{ invalidation
+    bool is_valid(Analysis a) const;
+    void invalidate(Analysis);                      ///< Invalidates @p a and all its transitive dependents.
+    void invalidate() { invalidate(Analysis::CFA); } ///< Invalidates everything.
+    //@}
+
+    //@{ statistics
+    const Stats& stats(Analysis a) const { return stats_[size_t(a)]; }
+    static const char* name(Analysis);
+    Printer& stream(Printer&) const override; ///< Streams the build counts and times of all analyses.
+    //@}
+
+private:
+    template<class T, class... Args>
+    const T& build(Analysis, std::unique_ptr<const T>&, Args&&...) const;
+
+    const Scope& scope_;
+    mutable std::unique_ptr<const CFA> cfa_;
+    mutable std::unique_ptr<const F_CFG> f_cfg_;
+    mutable std::unique_ptr<const B_CFG> b_cfg_;
+    mutable std::unique_ptr<const DomTree> domtree_;
+    mutable std::unique_ptr<const PostDomTree> postdomtree_;
+    mutable std::unique_ptr<const DomFrontiers> domfrontiers_;
+    mutable std::unique_ptr<const ControlDeps> controldeps_;
+    mutable std::unique_ptr<const LoopTree<true>> f_looptree_;
+    mutable std::unique_ptr<const LoopTree<false>> b_looptree_;
+    mutable std::array<std::unique_ptr<const Schedule>, Schedule::GCM + 1> schedules_;
+    mutable std::array<Stats, Num> stats_;
+};
+
+template<bool forward>
+const CFG<forward>& AnalysisManager::cfg() const {
+    cfa();
+    if constexpr (forward) return build(Analysis::F_CFG, f_cfg_, *cfa_);
+    else                   return build(Analysis::B_CFG, b_cfg_, *cfa_);
+}
+
+template<bool forward>
+const DomTreeBase<forward>& AnalysisManager::domtree() const {
+    auto& g = cfg<forward>();
+    if constexpr (forward) return build(Analysis::DomTree,     domtree_,     g);
+    else                   return build(Analysis::PostDomTree, postdomtree_, g);
+}
+
+template<bool forward>
+const DomFrontierBase<forward>& AnalysisManager::domfrontier() const {
+    auto& g = cfg<forward>();
+    domtree<forward>();
+    if constexpr (forward) return build(Analysis::DomFrontiers, domfrontiers_, g);
+    else                   return build(Analysis::ControlDeps,  controldeps_,  g);
+}
+
+template<bool forward>
+const LoopTree<forward>& AnalysisManager::looptree() const {
+    auto& g = cfg<forward>();
+    if constexpr (forward) return build(Analysis::F_LoopTree, f_looptree_, g);
+    else                   return build(Analysis::B_LoopTree, b_looptree_, g);
+}
+
+template<class T, class... Args>
+const T& AnalysisManager::build(Analysis a, std::unique_ptr<const T>& ptr, Args&&... args) const {
+    if (!ptr) {
+        auto start = std::chrono::steady_clock::now();
+        ptr = std::make_unique<const T>(std::forward<Args>(args)...);
+        auto& stats = stats_[size_t(a)];
+        ++stats.builds;
+        stats.time += std::chrono::steady_clock::now() - start;
+    }
+    return *ptr;
+}
+
+}
+
+#endif
@@ -8,203 +8,253 @@
 #include "thorin/analyses/looptree.h"
 #include "thorin/analyses/scope.h"
 #include "thorin/util/log.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
-typedef DefMap<const CFNode*> Def2CFNode;
-
 //------------------------------------------------------------------------------
 
-class Scheduler {
-public:
-    Scheduler(const Scope& scope, Schedule& schedule)
-        : scope_(scope)
-        , cfg_(scope.f_cfg())
-        , domtree_(cfg_.domtree())
-        , looptree_(cfg_.looptree())
-        , schedule_(schedule)
-    {
-        compute_def2uses();
-        Def2CFNode* def2node = nullptr;
-
-        switch (schedule.tag()) {
-            case Schedule::Early: schedule_early(); def2node = &def2early_; break;
-            case Schedule::Late:  schedule_late();  def2node = &def2late_;  break;
-            case Schedule::Smart: schedule_smart(); def2node = &def2smart_; break;
-        }
+unsigned CostTable::operator[](const Def* def) const {
+    // partial applications of curried Axiom%s are free - only the saturated App does the actual work
+    if (!def->isa<App>() || def->type()->isa<Pi>())
+        return 0;
 
-        for (const auto& p : *def2node)
-            schedule[p.second].defs_.push_back(p.first);
+    auto callee = def;
+    while (auto app = callee->isa<App>())
+        callee = app->callee();
 
-        topo_sort(*def2node);
+    if (auto axiom = callee->isa<Axiom>()) {
+        auto i = costs_.find(axiom);
+        if (i != costs_.end())
+            return i->second;
     }
 
-    void for_all_defs(std::function<void(const Def*)> f) {
-        for (const auto& p : def2uses_) {
-            f(p.first);
-        }
-    }
+    return default_cost();
+}
 
-    const Uses& uses(const Def* def) const { return def2uses_.find(def)->second; }
-    void compute_def2uses();
-    void schedule_early() { for_all_defs([&](const Def* def) { schedule_early(def); }); }
-    void schedule_late()  { for_all_defs([&](const Def* def) { schedule_late (def); }); }
-    void schedule_smart() { for_all_defs([&](const Def* def) { schedule_smart(def); }); }
-    const CFNode* schedule_early(const Def*);
-    const CFNode* schedule_late(const Def*);
-    const CFNode* schedule_smart(const Def*);
-    void topo_sort(Def2CFNode&);
+//------------------------------------------------------------------------------
+
+/**
+ * Places all Def%s of a Scope in linear time.
+ * All Def%s are numbered densely by the Scope and sorted topologically once such that operands precede their users.
+ * Placements are kept in flat arrays indexed by this numbering instead of hash maps:
+ * Early placements are computed in a single forward sweep, late placements in a single backward sweep.
+ * Since the topological order is global, filling the Block%s in this order already yields a valid order within each Block.
+ * Def%s without any user in the Scope are dead and will not be scheduled.
+ */
+class Scheduler {
+public:
+    Scheduler(const Scope&, Schedule&, const CostTable&);
 
 private:
+    static constexpr uint32_t None = uint32_t(-1);
+
+    /// Dense index of @p def or @p None if @p def is not contained in the Scope.
+    uint32_t index(const Def* def) const {
+        auto i = def != nullptr ? scope_.index(def) : Scope::None;
+        return i == Scope::None ? None : uint32_t(i);
+    }
+    /// Is @p op an operand that needs to be placed?
+    /// Lambda%s are placed by the CFG and, thus, cut all dependencies.
+    bool is_placed(const Def* op) const { return index(op) != None && !op->isa_lambda(); }
+    void topo_sort();
+    void schedule_early();
+    void schedule_late();
+    void schedule_smart();
+    void schedule_gcm();
+    /// Picks the Block between @p early and @p late with the smallest loop depth - the latest one on ties.
+    const CFNode* shallowest(const Def* def, const CFNode* early, const CFNode* late) const;
+
     const Scope& scope_;
     const F_CFG& cfg_;
     const DomTree& domtree_;
-    const LoopTree<true>& looptree_;
-    DefMap<Uses> def2uses_;
-    Def2CFNode def2early_;
-    Def2CFNode def2late_;
-    Def2CFNode def2smart_;
     Schedule& schedule_;
+    const CostTable& costs_;
+    ArrayRef<const Def*> defs_;     ///< Maps dense index to Def.
+    std::vector<uint32_t> topo_;    ///< Dense indices in topological order.
+    Array<const CFNode*> early_;
+    Array<const CFNode*> late_;
+    Array<const CFNode*> smart_;
+    Array<const CFNode*> gcm_;
 };
 
-void Scheduler::compute_def2uses() {
-    for (auto def : scope_.defs()) {
-        auto& uses = def2uses_[def];
-        for (auto use : def->uses()) {
-            if (scope_.contains(use))
-                uses.emplace(use);
+Scheduler::Scheduler(const Scope& scope, Schedule& schedule, const CostTable& costs)
+    : scope_(scope)
+    , cfg_(scope.f_cfg())
+    , domtree_(cfg_.domtree())
+    , schedule_(schedule)
+    , costs_(costs)
+    , defs_(scope.defs())
+    , early_(scope.defs().size())
+    , late_(scope.defs().size())
+{
+    topo_sort();
+    schedule_early();
+    schedule_late();
+
+    const Array<const CFNode*>* placement = nullptr;
+    switch (schedule.tag()) {
+        case Schedule::Early: placement = &early_; break;
+        case Schedule::Late:  placement = &late_;  break;
+        case Schedule::Smart: schedule_smart(); placement = &smart_; break;
+        case Schedule::GCM:   schedule_gcm();   placement = &gcm_;   break;
+    }
+
+    for (auto i : topo_) {
+        if (late_[i] != nullptr)
+            schedule[(*placement)[i]].defs_.push_back(defs_[i]);
+    }
+}
+
+void Scheduler::topo_sort() {
+    // iterative post-order DFS along the operands
+    enum : uint8_t { Fresh, Active, Done };
+    Array<uint8_t> state(defs_.size(), Fresh);
+    std::vector<std::pair<uint32_t, size_t>> stack;
+    topo_.reserve(defs_.size());
+
+    for (uint32_t root = 0, e = defs_.size(); root != e; ++root) {
+        if (state[root] != Fresh) continue;
+        state[root] = Active;
+        stack.emplace_back(root, 0);
+
+        while (!stack.empty()) {
+            auto& [i, o] = stack.back();
+            auto def = defs_[i];
+
+            if (o != def->num_ops()) {
+                auto op = def->op(o++);
+                if (is_placed(op)) {
+                    auto j = index(op);
+                    assert(state[j] != Active && "cyclic dependency not broken by a Lambda");
+                    if (state[j] == Fresh) {
+                        state[j] = Active;
+                        stack.emplace_back(j, 0);
+                    }
+                }
+            } else {
+                state[i] = Done;
+                topo_.push_back(i);
+                stack.pop_back();
+            }
         }
     }
 }
 
-const CFNode* Scheduler::schedule_early(const Def* def) {
-    auto i = def2early_.find(def);
-    if (i != def2early_.end())
-        return i->second;
+void Scheduler::schedule_early() {
+    for (auto i : topo_) {
+        auto def = defs_[i];
 
-    if (auto param = def->isa<Param>()) {
-        DLOG("early: {} <- {}", param->lambda(), def);
-        return def2early_[def] = cfg_[param->lambda()];
-    }
+        if (auto param = def->isa<Param>()) {
+            early_[i] = cfg_[param->lambda()];
+            continue;
+        }
 
-    auto result = cfg_.entry();
-    for (auto op : def->ops()) {
-        if (!op->isa_lambda() && def2uses_.find(op) != def2uses_.end()) {
-            auto n = schedule_early(op);
-            if (domtree_.depth(n) > domtree_.depth(result))
-                result = n;
+        auto result = cfg_.entry();
+        for (auto op : def->ops()) {
+            if (is_placed(op)) {
+                auto n = early_[index(op)];
+                if (domtree_.depth(n) > domtree_.depth(result))
+                    result = n;
+            }
         }
+        early_[i] = result;
     }
-
-    DLOG("early: {} <- {}", result, def);
-    return def2early_[def] = result;
 }
 
-const CFNode* Scheduler::schedule_late(const Def* def) {
-    auto i = def2late_.find(def);
-    if (i != def2late_.end())
-        return i->second;
+void Scheduler::schedule_late() {
+    // all users precede their operands in reverse topological order - so push each final placement down to the operands
+    for (auto i : reverse_range(topo_)) {
+        auto def = defs_[i];
 
-    if (auto lambda = def->isa_lambda()) {
-        DLOG("late: {} <- {}", lambda, lambda);
-        return def2late_[lambda] = cfg_[lambda];
-    }
+        if (auto lambda = def->isa_lambda())
+            late_[i] = cfg_[lambda];
+        else if (late_[i] == nullptr)
+            continue; // dead within this Scope - neither placed nor constraining its operands
 
-    const CFNode* result = nullptr;
-    for (auto use : uses(def)) {
-        auto n = schedule_late(use);
-        result = result ? domtree_.lca(result, n) : n;
+        for (auto op : def->ops()) {
+            if (is_placed(op)) {
+                auto& late = late_[index(op)];
+                late = late ? domtree_.lca(late, late_[i]) : late_[i];
+            }
+        }
     }
+}
 
-    DLOG("late: {} <- {}", result, def);
-    return def2late_[def] = result;
+void Scheduler::schedule_smart() {
+    smart_ = Array<const CFNode*>(defs_.size());
+
+    for (auto i : topo_) {
+        if (late_[i] != nullptr)
+            smart_[i] = shallowest(defs_[i], early_[i], late_[i]);
+    }
 }
 
-const CFNode* Scheduler::schedule_smart(const Def* def) {
-    auto i = def2smart_.find(def);
-    if (i != def2smart_.end())
-        return i->second;
+void Scheduler::schedule_gcm() {
+    // Click, 1995. Global Code Motion/Global Value Numbering. https://doi.org/10.1145/207110.207154
+    // In contrast to late_, the latest Block of a Def is derived from the final placement of its users.
+    // Thus, an operand of a hoisted Def may be hoisted as well.
+    Array<const CFNode*> late(defs_.size());
+    gcm_ = Array<const CFNode*>(defs_.size());
+
+    for (auto i : reverse_range(topo_)) {
+        auto def = defs_[i];
+
+        if (auto lambda = def->isa_lambda())
+            gcm_[i] = cfg_[lambda];
+        else if (late[i] == nullptr)
+            continue;
+        else if (costs_.is_expensive(def))
+            gcm_[i] = shallowest(def, early_[i], late[i]);
+        else
+            gcm_[i] = late[i];
+
+        for (auto op : def->ops()) {
+            if (is_placed(op)) {
+                auto& l = late[index(op)];
+                l = l ? domtree_.lca(l, gcm_[i]) : gcm_[i];
+            }
+        }
+    }
+}
 
-    auto early = schedule_early(def);
-    auto late  = schedule_late (def);
+const CFNode* Scheduler::shallowest(const Def* def, const CFNode* early, const CFNode* late) const {
+    auto& looptree = cfg_.looptree();
+    auto result = late;
+    int depth = looptree[late]->depth();
 
-    const CFNode* result;
-    result = late;
-    int depth = looptree_[late]->depth();
-    for (auto i = late; i != early;) {
-        auto idom = domtree_.idom(i);
-        assert(i != idom);
-        i = idom;
+    for (auto n = late; n != early;) {
+        auto idom = domtree_.idom(n);
+        assert(n != idom);
+        n = idom;
 
         // HACK this should actually never occur
-        if (i == nullptr) {
+        if (n == nullptr) {
             WLOG("don't know where to put {}", def);
-            result = late;
-            break;
+            return late;
         }
 
-        int cur_depth = looptree_[i]->depth();
+        int cur_depth = looptree[n]->depth();
         if (cur_depth < depth) {
-            result = i;
+            result = n;
             depth = cur_depth;
         }
     }
 
-    DLOG("smart: {} <- {}", result, def);
-    return def2smart_[def] = result;
-}
-
-void Scheduler::topo_sort(Def2CFNode& def2node) {
-    for (auto& block : schedule_.blocks_) {
-        std::vector<const Def*> defs;
-        std::queue<const Def*> queue;
-        DefSet done;
-
-        auto inside = [&](const Def* def) {
-            auto i = def2node.find(def);
-            return i != def2node.end() && i->second == block.node();
-        };
-
-        auto enqueue = [&](const Def* def) {
-            if (!done.contains(def)) {
-                for (auto op : def->ops()) {
-                    if (inside(op) && !done.contains(op))
-                        return;
-                }
-
-                queue.push(def);
-                done.emplace(def);
-                defs.push_back(def);
-            }
-        };
-
-        for (auto def : block)
-            enqueue(def);
-
-        while (!queue.empty()) {
-            auto def = pop(queue);
-
-            for (auto use : uses(def)) {
-                if (inside(use))
-                    enqueue(use);
-            }
-        }
-
-        assert(block.defs_.size() == defs.size());
-        swap(block.defs_, defs);
-    }
+    return result;
 }
 
 //------------------------------------------------------------------------------
 
-Schedule::Schedule(const Scope& scope, Tag tag)
+Schedule::Schedule(const Scope& scope, Tag tag, const CostTable& costs)
     : scope_(scope)
     , indices_(cfg())
     , blocks_(cfa().size())
     , tag_(tag)
 {
+    THORIN_TRACE("Schedule");
     block_schedule();
-    Scheduler(scope, *this);
+    Scheduler(scope, *this, costs);
     verify();
 }
 
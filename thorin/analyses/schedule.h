@@ -6,9 +6,41 @@
 
 namespace thorin {
 
+/**
+ * Assigns each Def a cost which is used by Schedule::GCM to decide whether moving a Def pays off.
+ * A saturated App of an Axiom costs what has been registered for this Axiom via @p set.
+ * All other saturated App%s cost @p default_cost.
+ * All other Def%s - tuples, extracts, literals, partial App%s, etc. - are free.
+ */
+class CostTable {
+public:
+    CostTable(unsigned default_cost = 1, unsigned hoist_threshold = 1)
+        : default_cost_(default_cost)
+        , hoist_threshold_(hoist_threshold)
+    {}
+
+    CostTable& set(const Axiom* axiom, unsigned cost) { costs_[axiom] = cost; return *this; }
+    unsigned default_cost() const { return default_cost_; }
+    unsigned hoist_threshold() const { return hoist_threshold_; }
+    unsigned operator[](const Def*) const;
+    /// Is it worth hoisting @p def out of a loop? Otherwise, @p def is sunk as far as possible to shorten its live range.
+    bool is_expensive(const Def* def) const { return (*this)[def] >= hoist_threshold(); }
+
+private:
+    GIDMap<const Axiom*, unsigned> costs_;
+    unsigned default_cost_;
+    unsigned hoist_threshold_;
+};
+
 class Schedule : public Streamable<Printer> {
 public:
-    enum Tag { Early, Late, Smart };
+    /**
+     * @p Early places each Def in the first, @p Late in the last possible Block.
+     * @p Smart picks the Block with the smallest loop depth in between.
+     * @p GCM performs Click-style global code motion guided by a CostTable:
+     * Expensive Def%s are hoisted out of loops, cheap ones are sunk as deep as possible into the branches using them.
+     */
+    enum Tag { Early, Late, Smart, GCM };
 
     class Block {
     public:
@@ -48,7 +80,7 @@ public:
         , blocks_(std::move(other.blocks_))
         , tag_(std::move(other.tag_))
     {}
-    Schedule(const Scope&, Tag = Smart);
+    Schedule(const Scope&, Tag = Smart, const CostTable& = {});
 
     Tag tag() const { return tag_; }
     const Scope& scope() const { return scope_; }
@@ -82,7 +114,9 @@ private:
     friend class Scheduler;
 };
 
-inline Schedule schedule(const Scope& scope, Schedule::Tag tag = Schedule::Smart) { return Schedule(scope, tag); }
+inline Schedule schedule(const Scope& scope, Schedule::Tag tag = Schedule::Smart, const CostTable& costs = {}) {
+    return Schedule(scope, tag, costs);
+}
 
 }
 
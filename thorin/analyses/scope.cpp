@@ -7,40 +7,77 @@
 #include "thorin/analyses/cfg.h"
 #include "thorin/analyses/domtree.h"
 #include "thorin/analyses/looptree.h"
+#include "thorin/analyses/manager.h"
 #include "thorin/analyses/schedule.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
 Scope::Scope(Lambda* entry)
-    : entry_(entry)
-    , exit_(entry->world().cn_end())
+    : world_(entry->world())
+    , entry_(entry)
+    , exit_(world_.cn_end())
 {
+    THORIN_TRACE("Scope");
     run();
 }
 
-Scope::~Scope() {}
+Scope::~Scope() { unmark(); }
 
 Scope& Scope::update() {
+    if (analyses_) analyses_->invalidate();
+    unmark();
     defs_.clear();
-    cfa_ = nullptr;
-    free_ = nullptr;
+    free_.clear();
+    saved_.clear();
+    run();
     return *this;
 }
 
+void Scope::mark(const Def* def, size_t i) {
+    if (prev_stamp_ != 0)
+        saved_.push_back(def->scope_index_);
+    def->scope_index_ = i;
+}
+
+void Scope::unmark() {
+    if (world_.scope_stamp() != stamp_) return;
+
+    if (prev_stamp_ != 0) {
+        size_t j = 0;
+        for (auto def : defs_) def->scope_index_ = saved_[j++];
+        for (auto def : free_) def->scope_index_ = saved_[j++];
+    }
+    world_.scope_stamp() = prev_stamp_;
+}
+
+void Scope::remark() const {
+    // our predecessor's marks are gone for good - it will remark its Defs itself
+    for (size_t i = 0, e = defs_.size(); i != e; ++i) defs_[i]->scope_index_ = i;
+    for (size_t i = 0, e = free_.size(); i != e; ++i) free_[i]->scope_index_ = i;
+    saved_.clear();
+    prev_stamp_ = 0;
+    world_.scope_stamp() = stamp_;
+}
+
 void Scope::run() {
-    std::queue<const Def*> queue;
+    prev_stamp_ = world_.scope_stamp();
+    stamp_ = world_.scope_stamp() = world_.next_scope_stamp();
 
     auto enqueue = [&] (const Def* def) {
-        if (defs_.emplace(def).second)
-            queue.push(def);
+        if (!contains(def)) {
+            mark(def, defs_.size());
+            defs_.push_back(def);
+        }
     };
 
     // TODO maybe it's better to not include entry itself in the scope
     enqueue(entry_);
     enqueue(entry_->param());
 
-    while (!queue.empty()) {
-        auto def = pop(queue);
+    // defs_ doubles as BFS queue
+    for (size_t i = 0; i != defs_.size(); ++i) {
+        auto def = defs_[i];
         if (def != entry_) {
             for (auto use : def->uses())
                 enqueue(use);
@@ -48,26 +85,22 @@ void Scope::run() {
     }
 
     enqueue(world().cn_end());
-}
-
-const DefSet& Scope::free() const {
-    if (!free_) {
-        free_ = std::make_unique<DefSet>();
 
-        for (auto def : defs_) {
-            for (auto op : def->ops()) {
-                if (!contains(op))
-                    free_->emplace(op);
+    // now that the Scope is complete, collect the free Defs in a single sweep
+    for (auto def : defs_) {
+        for (auto op : def->ops()) {
+            if (op != nullptr && !contains(op) && !is_free(op)) {
+                mark(op, free_.size());
+                free_.push_back(op);
             }
         }
     }
-
-    return *free_;
 }
 
-const CFA& Scope::cfa() const { return lazy_init(this, cfa_); }
-const F_CFG& Scope::f_cfg() const { return cfa().f_cfg(); }
-const B_CFG& Scope::b_cfg() const { return cfa().b_cfg(); }
+AnalysisManager& Scope::analyses() const { return lazy_init(this, analyses_); }
+const CFA& Scope::cfa() const { return analyses().cfa(); }
+const F_CFG& Scope::f_cfg() const { return analyses().cfg<true>(); }
+const B_CFG& Scope::b_cfg() const { return analyses().cfg<false>(); }
 
 template<bool elide_empty>
 void Scope::for_each(const World& world, std::function<void(Scope&)> f) {
@@ -102,8 +135,8 @@ void Scope::for_each(const World& world, std::function<void(Scope&)> f) {
 template void Scope::for_each<true> (const World&, std::function<void(Scope&)>);
 template void Scope::for_each<false>(const World&, std::function<void(Scope&)>);
 
-Printer& Scope::stream(Printer& p) const { return schedule(*this).stream(p); }
-void Scope::write_thorin(const char* filename) const { return schedule(*this).write_thorin(filename); }
-void Scope::thorin() const { schedule(*this).thorin(); }
+Printer& Scope::stream(Printer& p) const { return analyses().schedule().stream(p); }
+void Scope::write_thorin(const char* filename) const { return analyses().schedule().write_thorin(filename); }
+void Scope::thorin() const { analyses().schedule().thorin(); }
 
 }
@@ -3,7 +3,7 @@
 
 #include <vector>
 
-#include "thorin/def.h"
+#include "thorin/world.h"
 #include "thorin/util/array.h"
 #include "thorin/util/stream.h"
 
@@ -13,6 +13,7 @@ template<bool> class CFG;
 typedef CFG<true>  F_CFG;
 typedef CFG<false> B_CFG;
 
+class AnalysisManager;
 class CFA;
 class CFNode;
 
@@ -20,6 +21,10 @@ class CFNode;
  * A @p Scope represents a region of @p Lambda%s which are live from the view of an @p entry @p Lambda.
  * Transitively, all user's of the @p entry's parameters are pooled into this @p Scope.
  * Each @p Scope contains the dummy @p Lambda @p World::lambda_end to mark the end of a @p Scope.
+ * Membership is tracked via marks on the Def%s themselves, so neither construction nor queries need to hash.
+ * Only one Scope per World owns these marks at a time.
+ * A Scope hands the marks back to its predecessor when it dies, so nested Scope%s - as built by @p drop - don't interfere.
+ * Otherwise, a Scope whose marks have been overwritten re-marks its Def%s on the next query in O(|defs| + |free|).
  */
 class Scope : public Streamable<Printer> {
 public:
@@ -35,22 +40,39 @@ public:
     //@{ misc getters
     Lambda* entry() const { return entry_; }
     Lambda* exit() const { return exit_; }
-    World& world() const { return entry_->world(); }
+    World& world() const { return world_; }
     //@}
 
     //@{ get Def%s contained/not contained in this Scope
-    const DefSet& defs() const { return defs_; }
-    bool contains(const Def* def) const { return defs_.contains(def); }
+    /// All @p Def%s contained in this @p Scope in breadth-first order starting with @p entry.
+    ArrayRef<const Def*> defs() const { return defs_; }
+    bool contains(const Def* def) const {
+        claim();
+        auto i = def->scope_index_;
+        return i < defs_.size() && defs_[i] == def;
+    }
+    /// Dense index of @p def in @p defs or @p None if @p def is not contained in this @p Scope.
+    size_t index(const Def* def) const { return contains(def) ? def->scope_index_ : None; }
     /// All @p Def%s referenced but @em not contained in this @p Scope.
-    const DefSet& free() const;
+    ArrayRef<const Def*> free() const { return free_; }
+    bool is_free(const Def* def) const {
+        claim();
+        auto i = def->scope_index_;
+        return i < free_.size() && free_[i] == def;
+    }
     //@}
 
+    static constexpr size_t None = size_t(-1);
+
     //@{ simple CFA to construct a CFG
     const CFA& cfa() const;
     const F_CFG& f_cfg() const;
     const B_CFG& b_cfg() const;
     //@}
 
+    /// Memoizes all analyses of this Scope - invalidated by @p update.
+    AnalysisManager& analyses() const;
+
     //@{ dump
     // Note that we don't use overloading for the following methods in order to have them accessible from gdb.
     virtual Printer& stream(Printer&) const override;  ///< Streams thorin to file @p out.
@@ -68,12 +90,21 @@ public:
 
 private:
     void run();
+    void mark(const Def* def, size_t i);
+    /// Hands the marks back to the predecessor - if nobody else has overwritten them in the meantime.
+    void unmark();
+    void claim() const { if (world_.scope_stamp() != stamp_) remark(); }
+    void remark() const;
 
+    World& world_;
     Lambda* entry_;
     Lambda* exit_;
-    DefSet defs_;
-    mutable std::unique_ptr<DefSet> free_;
-    mutable std::unique_ptr<const CFA> cfa_;
+    std::vector<const Def*> defs_;
+    std::vector<const Def*> free_;
+    mutable std::vector<uint32_t> saved_; ///< Marks of the predecessor in the order of @p defs_ followed by @p free_.
+    mutable uint64_t stamp_ = 0;
+    mutable uint64_t prev_stamp_ = 0;
+    mutable std::unique_ptr<AnalysisManager> analyses_;
 };
 
 }
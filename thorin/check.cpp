@@ -1,6 +1,7 @@
 #include "thorin/check.h"
 #include "thorin/world.h"
 #include "thorin/transform/reduce.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
@@ -37,8 +38,12 @@ void join_occurrences(std::vector<Occurrences>& tgt, const Array<Occurrences>& b
 void TypeCheck::check(const Def* def, DefVector& types) {
     if (def->free_vars().none())
         types = {};
-    if (done_.emplace(DefArray(types), def).second)
+    if (done_.emplace(DefArray(types), def).second) {
+        THORIN_STATS(++misses_);
         def->check(*this, types);
+    } else {
+        THORIN_STATS(++hits_);
+    }
 }
 
 void fcheck(TypeCheck& tc, const Def* def, DefVector& types) {
@@ -61,6 +66,7 @@ void dependent_check(TypeCheck& tc, DefVector& types, Defs defs, Defs bodies) {
 }
 
 void Def::check() const {
+    THORIN_TRACE("Def::check");
     world().check(this);
 }
 
@@ -2,6 +2,7 @@
 #define THORIN_CHECk_H
 
 #include "thorin/def.h"
+#include "thorin/stats.h"
 
 namespace thorin {
 
@@ -59,6 +60,10 @@ public:
     }
 
     void check(const Def* def, DefVector& types);
+#ifdef THORIN_ENABLE_STATS
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+#endif
 
     DefMap<Array<Occurrences>> occurrences;
 
@@ -77,6 +82,8 @@ private:
     };
 
     HashSet<EnvDef, EnvDefHash> done_;
+    THORIN_STATS(size_t hits_ = 0;)
+    THORIN_STATS(size_t misses_ = 0;)
 };
 
 }
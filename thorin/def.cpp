@@ -47,7 +47,36 @@ bool is_type_qualifier(const Def* def) { return def == def->world().type_qualifi
  * misc
  */
 
-uint32_t Def::gid_counter_ = 1;
+std::atomic<uint32_t> Def::gid_counter_(1);
+
+static World& world_of(Def::Tag tag, const Def* type) {
+    return tag == Def::Tag::Universe || tag == Def::Tag::Unknown ? *reinterpret_cast<World*>(const_cast<Def*>(type)) : type->world();
+}
+
+unsigned Def::world_index(Tag tag, const Def* type) {
+    auto index = world_of(tag, type).index();
+    assert(index < World::Max_Worlds);
+    return index;
+}
+
+uint32_t Def::intern_debug(Tag tag, const Def* type, const Debug& dbg) {
+    if (!dbg.is_set() && dbg.name().empty())
+        return 0;
+    return world_of(tag, type).debug_table().intern(dbg);
+}
+
+uint32_t Def::defer_debug(Tag tag, const Def* type, const Debug& dbg) {
+    world_of(tag, type).debug_table().defer(dbg);
+    return 0;
+}
+
+const Debug& Def::debug() const {
+    auto& world = World::of(world_index_);
+    assert(&world == &this->world());
+    return world.debug_table()[debug_];
+}
+
+void Def::set_debug(Debug dbg) const { debug_ = World::of(world_index_).debug_table().intern(dbg); }
 
 Debug Def::debug_history() const {
 #ifndef NDEBUG
@@ -60,18 +89,31 @@ Debug Def::debug_history() const {
 
 const Def* App::unfold() const {
     if (has_axiom()) return this;
-    if (cache()) return cache();
 
     const Def* callee = this->callee();
     if (auto app = callee->isa<App>())
         callee = app->unfold();
 
-    if (auto lambda = callee->isa_lambda()) {
-        assert(lambda->is_nominal());
-        auto res = drop(lambda, {arg()})->body();
-        assert(cache() == nullptr);
-        extra().cache_.set_ptr(res);
-        return res;
+    if (auto lambda = callee->isa<Lambda>()) {
+        if (lambda->is_nominal()) {
+            // Any nominal within the dropped Scope may have been mutated since - not only lambda itself.
+            // Instead of tracking all of them, a cache computed before the last mutation of any nominal is considered stale.
+            if (cache() && extra().generation_ == world().generation())
+                return cache();
+
+            auto res = drop(lambda->as_lambda(), {arg()})->body();
+            extra().cache_.set_ptr(res);
+            extra().generation_ = world().generation();
+            return res;
+        }
+
+        if (cache())
+            return cache();
+
+        auto& affine_unfolds = world().affine_unfolds();
+        if (auto res = find(affine_unfolds, this))
+            return res;
+        return affine_unfolds[this] = reduce(lambda->body(), arg());
     }
 
     return this;
@@ -122,10 +164,14 @@ Def* Def::set(Defs defs) {
 }
 
 void Def::finalize() {
+    auto& table = world().free_vars_table();
+    if (auto var = isa<Var>())
+        free_vars_ = table.var(var->index());
+
     for (size_t i = 0, e = num_ops(); i != e; ++i) {
         assert(op(i) != nullptr);
         checked_emplace(op(i)->uses_, Use{this, i});
-        free_vars_    |= op(i)->free_vars() >> shift(i);
+        free_vars_    = table.unite(free_vars_, table.shift(op(i)->free_vars_, shift(i)));
         contains_lambda_ |= op(i)->tag() == Tag::Lambda || op(i)->contains_lambda();
         is_dependent_ |= is_dependent_ || op(i)->free_vars().any_end(i);
     }
@@ -134,7 +180,7 @@ void Def::finalize() {
         is_dependent_ = false;
 
     if (type() != nullptr)
-        free_vars_ |= type()->free_vars_;
+        free_vars_ = table.unite(free_vars_, type()->free_vars_);
 
     assert((!is_nominal() || free_vars().none()) && "nominals must not have free vars");
 
@@ -146,6 +192,8 @@ void Def::unset(size_t i) {
     assert(ops_ptr()[i] && "must be set");
     unregister_use(i);
     ops_ptr()[i] = nullptr;
+    if (is_nominal())
+        generation_ = world().next_generation();
 }
 
 void Def::unregister_uses() const {
@@ -588,6 +636,7 @@ bool Variadic::assignable(const Def* def) const {
  */
 
 Lambda* Lambda::set(const Def* body) { return set(world().lit_false(), body); }
+Lambda* Lambda::reset(const Def* body) { return reset(world().lit_false(), body); }
 const Param* Lambda::param(Debug dbg) const { return world().param(this, dbg); }
 const Def* Lambda::param(u64 i, Debug dbg) const { return world().extract(param(), i, dbg); }
 
@@ -1,6 +1,8 @@
 #ifndef THORIN_DEF_H
 #define THORIN_DEF_H
 
+#include <atomic>
+#include <optional>
 #include <set>
 
 #include "thorin/util/array.h"
@@ -10,6 +12,7 @@
 #include "thorin/util/iterator.h"
 #include "thorin/util/debug.h"
 #include "thorin/util/types.h"
+#include "thorin/free_vars.h"
 #include "thorin/print.h"
 #include "thorin/qualifier.h"
 
@@ -128,28 +131,30 @@ protected:
 
     /// A @em nominal Def.
     Def(Tag tag, const Def* type, size_t num_ops, Debug dbg)
-        : debug_(dbg)
-        , type_(type)
+        : type_(type)
         , num_ops_(num_ops)
-        , gid_(gid_counter_++)
+        , gid_(next_gid())
         , tag_(unsigned(tag))
         , nominal_(true)
         , contains_lambda_(false)
         , is_dependent_(false)
+        , world_index_(world_index(tag, type))
+        , debug_(intern_debug(tag, type, dbg))
     {
         std::fill_n(ops_ptr(), num_ops, nullptr);
     }
     /// A @em structural Def.
     template<class I>
     Def(Tag tag, const Def* type, Range<I> ops, Debug dbg)
-        : debug_(dbg)
-        , type_(type)
+        : type_(type)
         , num_ops_(ops.distance())
-        , gid_(gid_counter_++)
+        , gid_(next_gid())
         , tag_(unsigned(tag))
         , nominal_(false)
         , contains_lambda_(false)
         , is_dependent_(false)
+        , world_index_(world_index(tag, type))
+        , debug_(defer_debug(tag, type, dbg))
     {
         std::copy(ops.begin(), ops.end(), ops_ptr());
     }
@@ -159,6 +164,16 @@ protected:
     {}
 
     void finalize();
+    static uint32_t next_gid() {
+        auto gid = gid_counter_++;
+        assert(gid != 0 && "gid counter wrapped around");
+        return gid;
+    }
+    /// @p type is the @p World itself for @p Universe and @p Unknown.
+    static unsigned world_index(Tag tag, const Def* type);
+    static uint32_t intern_debug(Tag tag, const Def* type, const Debug& dbg);
+    /// Structural Defs get their handle in @p World::unify only if they are not deduplicated; until then it is 0.
+    static uint32_t defer_debug(Tag tag, const Def* type, const Debug& dbg);
     void unset(size_t i);
     void unregister_use(size_t i) const;
     void unregister_uses() const;
@@ -181,12 +196,14 @@ public:
     Array<Use> copy_uses() const { return Array<Use>(uses_.begin(), uses_.end()); }
     //@}
 
-    //@{ get Debug information
-    Debug& debug() const { return debug_; }
+    //@{ get/set Debug information - interned in the @p DebugTable of the @p World
+    const Debug& debug() const;
     /// In Debug build if World::enable_history is true, this thing keeps the gid to track a history of gid%s.
     Debug debug_history() const;
-    Loc loc() const { return debug_; }
+    Loc loc() const { return debug(); }
     Symbol name() const { return debug().name(); }
+    void set_debug(Debug dbg) const;
+    void set_name(Symbol name) const { set_debug({debug(), name}); }
     std::string unique_name() const;
     //@}
 
@@ -218,12 +235,14 @@ public:
 
     //@{ misc getters
     virtual const Def* arity() const;
-    const BitSet& free_vars() const { return free_vars_; }
+    const FreeVars& free_vars() const { return *free_vars_; }
     uint32_t fields() const { return uint32_t(num_ops_) << 8_u32 | uint32_t(tag()); }
     uint32_t gid() const { return gid_; }
     static uint32_t gid_counter() { return gid_counter_; }
     /// A nominal Def is always different from each other Def.
     bool is_nominal() const { return nominal_; }
+    /// Stamp of the last mutation of this nominal via @p unset - @c 0 if never mutated; see World::next_generation.
+    uint32_t generation() const { return generation_; }
     Tag tag() const { return Tag(tag_); }
     bool is_dependent() const { return is_dependent_; }
     //@}
@@ -266,7 +285,8 @@ public:
     //@}
 
     //@{ stream
-    DefPrinter& qualifier_stream(DefPrinter&) const;
+    /// Prints via @p DefWriter which has a dedicated code path for each @p Tag.
+    DefPrinter& stream(DefPrinter&) const override;
     DefPrinter& stream_assign(DefPrinter&) const;
     void dump_assign() const;
     void dump_rec() const;
@@ -288,37 +308,39 @@ private:
     virtual const Def* kind_qualifier() const;
     virtual bool vsubtype_of(const Def*) const { return false; }
 
-    static uint32_t gid_counter_;
-
-protected:
-    BitSet free_vars_;
+    static std::atomic<uint32_t> gid_counter_; ///< Shared by all World%s - which may live on different threads.
 
 private:
     struct Extra {};
 
     mutable Uses uses_;
     mutable uint64_t hash_ = 0;
-    mutable Debug debug_;
     union {
         const Def* type_;
         mutable World* world_;
     };
     mutable const Def* substitute_ = nullptr;
+    const FreeVars* free_vars_ = &FreeVars::empty(); ///< Interned in the @p FreeVarsTable of the @p World.
     uint32_t num_ops_;
+    uint32_t gid_; ///< All 32 bits: @p GIDHash and friends rely on distinct Def%s having distinct gids.
     union {
         struct {
-            unsigned gid_             : 23;
             unsigned tag_             :  6;
             unsigned nominal_         :  1;
             unsigned contains_lambda_ :  1;
             unsigned is_dependent_    :  1;
-            // this sum must be 32  ^^^
+            unsigned world_index_     : 16; ///< @p World::index of the owning World - cheaper than @p world() for @p debug().
         };
     };
+    mutable uint32_t debug_; ///< Handle into the @p DebugTable of the @p World.
+    uint32_t generation_ = 0;
+    mutable uint32_t scope_index_ = 0; ///< Dense index within the @p Scope that currently owns the marks - see @p Scope.
 
     static_assert(int(Tag::Num) <= 64, "you must increase the number of bits in tag_");
 
     friend class App;
+    friend class Importer;
+    friend class Scope;
     friend class Tracker;
     friend class World;
     friend void swap(World&, World&);
@@ -362,7 +384,6 @@ public:
     const Def* kind_qualifier() const override;
     bool assignable(const Def* def) const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
 private:
     bool vsubtype_of(const Def*) const override;
@@ -393,7 +414,6 @@ public:
     const Def* kind_qualifier() const override;
     size_t shift(size_t) const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
 private:
     bool vsubtype_of(const Def* def) const override;
@@ -429,9 +449,17 @@ public:
     //@}
 
     //@{ set body -- nominal Lambda%s only
-    Lambda* set(const Def* filter, const Def* body) { /*unset(0); unset(1);*/ return Def::set(0, filter)->Def::set(1, body)->as<Lambda>(); }
+    Lambda* set(const Def* filter, const Def* body) { return Def::set(0, filter)->Def::set(1, body)->as<Lambda>(); }
     /// Uses @c false as filter.
     Lambda* set(const Def* body);
+    /// Like @p set but for an already set @p Lambda - bumps its @p generation.
+    Lambda* reset(const Def* filter, const Def* body) {
+        if (op(0)) unset(0);
+        if (op(1)) unset(1);
+        return set(filter, body);
+    }
+    /// Uses @c false as filter.
+    Lambda* reset(const Def* body);
     Lambda* jump(const Def* callee, const Def* arg, Debug dbg = {});
     Lambda* jump(const Def* callee, Defs args, Debug dbg = {});
     Lambda* br(const Def* cond, const Def* t, const Def* f, Debug dbg = {});
@@ -442,7 +470,6 @@ public:
     const Def* rebuild(World&, const Def*, Defs) const override;
     Lambda* vstub(World&, const Def*, Debug) const override;
     const Def* apply(const Def*) const;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -478,7 +505,6 @@ public:
     const Def* rebuild(World&, const Def*, Defs) const override;
     Sigma* vstub(World&, const Def*, Debug) const override;
     void check(TypeCheck&, DefVector&) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
 private:
     static const Def* max_type(Defs ops, const Def* qualifier);
@@ -503,7 +529,6 @@ public:
     void check(TypeCheck&, DefVector&) const override;
     size_t shift(size_t) const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -517,7 +542,6 @@ private:
 public:
     void check(TypeCheck&, DefVector&) const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -533,7 +557,6 @@ public:
     void check(TypeCheck&, DefVector&) const override;
     size_t shift(size_t) const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -549,7 +572,6 @@ public:
     const Def* index() const { return op(1); }
     void check(TypeCheck&, DefVector&) const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -565,7 +587,6 @@ public:
     const Def* index() const { return op(1); }
     const Def* value() const { return op(2); }
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -585,7 +606,6 @@ public:
     const Def* kind_qualifier() const override;
     bool has_values() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     struct Lattice {
         static constexpr auto min = Qualifier::l;
@@ -616,7 +636,6 @@ public:
     bool has_values() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
     Variant* vstub(World&, const Def*, Debug) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     struct Lattice {
         static constexpr auto min = Qualifier::u;
@@ -637,7 +656,6 @@ private:
 public:
     const Def* destructee() const { return op(0); }
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -654,7 +672,6 @@ public:
     const Def* handler(size_t i) const { return handlers()[i]; }
     size_t num_handlers() const { return handlers().size(); }
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -672,7 +689,6 @@ public:
     const Def* kind_qualifier() const override;
     bool has_values() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -688,7 +704,6 @@ private:
 public:
     const Def* arity() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -702,7 +717,6 @@ private:
     {
         assert(!type->is_universe());
         extra().index_ = index;
-        free_vars_.set(index);
     }
 
 public:
@@ -712,7 +726,6 @@ public:
     /// Do not print variable names as they aren't bound in the output without analysing DeBruijn-Indices.
     void check(TypeCheck&, DefVector&) const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
 private:
     uint64_t vhash() const override;
@@ -739,7 +752,6 @@ public:
     Box box() const { return extra().box_; }
     bool has_values() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
 private:
     uint64_t vhash() const override;
@@ -788,7 +800,6 @@ public:
     bool is_top() const { return tag() == Tag::Top; }
     const Def* arity() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -815,7 +826,6 @@ public:
     Lambda* lambda() const { return const_cast<Lambda*>(op(0)->as<Lambda>()); }
     const Def* arity() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -845,7 +855,6 @@ public:
     Axiom* vstub(World&, const Def*, Debug) const override;
     bool has_values() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
 private:
     Extra& extra() { return reinterpret_cast<Extra&>(*extra_ptr()); }
@@ -855,9 +864,15 @@ private:
 };
 
 class App : public Def {
+public:
+    /// Constant-folding kernel of an op-head; may throw to signal an undefined result.
+    typedef Box (*Fold)(Box, Box);
+
 private:
     struct Extra {
         mutable TaggedPtr<const Def, bool> cache_; // true if Axiom
+        mutable uint32_t generation_;              // World::generation when cache_ of a nominal callee was computed
+        mutable Fold fold_;                        // kernel specialized to the literal arguments of this op-head
     };
 
     App(const Def* type, const Def* callee, const Def* arg, Debug dbg)
@@ -867,6 +882,8 @@ private:
             extra().cache_ = TaggedPtr<const Def, bool>(axiom, true);
         else
             extra().cache_ = TaggedPtr<const Def, bool>(nullptr, false);
+        extra().generation_ = 0;
+        extra().fold_ = nullptr;
     }
 
 public:
@@ -875,17 +892,24 @@ public:
     const Def* arg() const { return op(1); }
     bool has_axiom() const { return extra().cache_.index(); }
     const Axiom* axiom() const { assert(has_axiom()); return extra().cache_->as<Axiom>(); }
+    /**
+     * The folding kernel an @p Axiom%'s normalizer specialized to this partially applied op-head - e.g. to flags and width.
+     * @c nullptr until the normalizer first folds an application of this App and caches its kernel via @p set_fold.
+     */
+    Fold fold() const { return extra().fold_; }
+    void set_fold(Fold fold) const { assert(has_axiom()); extra().fold_ = fold; }
 
     /**
      * Forces an unfold of this App if possible - may diverge.
      * Also unfolds recursively @p App%s that occur in callee position.
+     * The result is cached and recomputed if the unfolded nominal has been re-set in the meantime.
+     * Applications of structural affine @p Lambda%s, which World::app leaves alone, are cached in World::affine_unfolds.
      */
     const Def* unfold() const;
 
     const Def* arity() const override;
     bool has_values() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
 private:
     Extra& extra() { return reinterpret_cast<Extra&>(*extra_ptr()); }
@@ -908,7 +932,6 @@ public:
     const Def* arity() const override;
     const Def* rebuild(World&, const Def*, Defs) const override;
     Unknown* vstub(World&, const Def*, Debug) const override;
-    DefPrinter& stream(DefPrinter&) const override;
 
     friend class World;
 };
@@ -1,5 +1,9 @@
 #include <stdexcept>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "thorin/util/log.h"
 #include "thorin/fe/lexer.h"
 
@@ -15,11 +19,45 @@ inline bool oct(uint32_t c) { return '0' <= c && c <= '7'; }
 inline bool eE(uint32_t c)  { return c == 'e' || c == 'E'; }
 inline bool sgn(uint32_t c) { return c == '+' || c == '-'; }
 
+// runs of ASCII characters the buffer mode skips in bulk - neither may contain '\n' as the line/column bookkeeping relies on this
+struct Ident {
+    static bool is(char c) { return sym(c) || dec(c); }
+#ifdef __SSE2__
+    static __m128i is(__m128i v) {
+        auto in = [](__m128i v, char lo, char hi) {
+            return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(hi + 1), v));
+        };
+        auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20)); // non-ASCII bytes stay negative
+        return _mm_or_si128(_mm_or_si128(in(lower, 'a', 'z'), in(v, '0', '9')), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+    }
+#endif
+};
+
+struct Blank {
+    static bool is(char c) { return c == ' ' || c == '\t'; }
+#ifdef __SSE2__
+    static __m128i is(__m128i v) { return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))); }
+#endif
+};
+
+/// Returns the first position in [@p p, @p end) which is not in character class @p C - 16 bytes at a time if SSE2 is available.
+template<class C>
+static const char* scan(const char* p, const char* end) {
+#ifdef __SSE2__
+    for (; end - p >= 16; p += 16) {
+        auto mask = unsigned(_mm_movemask_epi8(C::is(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))));
+        if (mask != 0xffff) return p + __builtin_ctz(~mask);
+    }
+#endif
+    while (p != end && C::is(*p)) ++p;
+    return p;
+}
+
 Lexer::Lexer(std::istream& is, const char* filename)
-    : stream_(is)
+    : stream_(&is)
     , filename_(filename)
 {
-    if (!stream_) throw std::runtime_error("stream is bad");
+    if (!is) throw std::runtime_error("stream is bad");
     next();
     accept(0xfeff, false); // eat utf-8 BOM if present
     front_line_ = front_col_  = 1;
@@ -27,13 +65,24 @@ Lexer::Lexer(std::istream& is, const char* filename)
     peek_line_  = peek_col_   = 1;
 }
 
+Lexer::Lexer(std::string_view buffer, const char* filename, uint32_t line)
+    : cur_(buffer.data())
+    , end_(buffer.data() + buffer.size())
+    , filename_(filename)
+{
+    next();
+    accept(0xfeff, false); // eat utf-8 BOM if present
+    front_line_ = back_line_ = peek_line_ = line;
+    front_col_  = back_col_  = peek_col_  = 1;
+}
+
 inline bool is_bit_set(uint32_t val, uint32_t n) { return bool((val >> n) & 1_u32); }
 inline bool is_bit_clear(uint32_t val, uint32_t n) { return !is_bit_set(val, n); }
 
 // see https://en.wikipedia.org/wiki/UTF-8
 uint32_t Lexer::next() {
     uint32_t result = peek_;
-    uint32_t b1 = stream_.get();
+    uint32_t b1 = get();
     std::fill(peek_bytes_, peek_bytes_ + 4, 0);
     peek_bytes_[0] = b1;
 
@@ -46,7 +95,7 @@ uint32_t Lexer::next() {
 
     int n_bytes = 1;
     auto get_next_utf8_byte = [&] () {
-        uint32_t b = stream_.get();
+        uint32_t b = get();
         peek_bytes_[n_bytes++] = b;
         if (is_bit_clear(b, 7) || is_bit_set(b, 6))
             error("invalid utf-8 character");
@@ -97,11 +146,21 @@ uint32_t Lexer::next() {
     return 0;
 }
 
+/// Consumes a run of blanks in buffer mode.
+/// Equivalent to calling @p next for each of them.
+void Lexer::skip_blanks() {
+    if (stream_ != nullptr || !Blank::is(peek())) return;
+    auto end = scan<Blank>(cur_, end_);
+    peek_col_ += end - cur_;
+    cur_ = end;
+    next();
+}
+
 Token Lexer::lex() {
     while (true) {
         // skip whitespace
         if (accept_if(sp, false)) {
-            while (accept_if(sp, false)) {}
+            while (skip_blanks(), accept_if(sp, false)) {}
             continue;
         }
 
@@ -109,9 +168,23 @@ Token Lexer::lex() {
         front_line_ = peek_line_;
         front_col_ = peek_col_;
 
-        if (stream_.eof())
+        if (eof())
             return {loc(), TT::Eof};
 
+        // identifier fast path: slice it from the buffer
+        if (stream_ == nullptr && sym(peek())) {
+            auto begin = cur_ - 1;
+            auto end = scan<Ident>(cur_, end_);
+            peek_col_ += end - cur_;
+            cur_ = end;
+            next();
+
+            std::string_view id(begin, end - begin);
+            if (id == "cn")   return {loc(), TT::Cn};
+            if (id == "bool") return {loc(), TT::Bool};
+            return {loc(), Symbol(id)};
+        }
+
         if (accept('{')) return {loc(), TT::D_brace_l};
         if (accept('}')) return {loc(), TT::D_brace_r};
         if (accept('(')) return {loc(), TT::D_paren_l};
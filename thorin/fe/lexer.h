@@ -1,15 +1,24 @@
 #ifndef THORIN_FE_LEXER_H
 #define THORIN_FE_LEXER_H
 
+#include <optional>
+#include <string_view>
+
 #include "thorin/fe/token.h"
 #include "thorin/util/debug.h"
 #include "thorin/util/stream.h"
 
 namespace thorin::fe {
 
+/**
+ * Lexes either an @c std::istream or a contiguous buffer - e.g. a @p MappedFile.
+ * The buffer mode avoids the stream overhead, slices identifiers directly from the buffer, and skips runs of ASCII identifier characters and blanks several bytes at a time.
+ * The buffer must outlive the @p Lexer.
+ */
 class Lexer {
 public:
     Lexer(std::istream&, const char* filename);
+    Lexer(std::string_view buffer, const char* filename, uint32_t line = 1); ///< @p buffer starts at @p line.
 
     Token lex(); ///< Get next \p Token in stream.
     const char* filename() const { return filename_; }
@@ -52,12 +61,20 @@ private:
         throw std::logic_error(oss.str());
     }
 
+    uint32_t get() {
+        if (stream_ != nullptr) return stream_->get();
+        return cur_ != end_ ? uint32_t(uint8_t(*cur_++)) : uint32_t(std::istream::traits_type::eof());
+    }
+    bool eof() const { return peek_ == uint32_t(std::istream::traits_type::eof()); }
+    void skip_blanks();
     uint32_t next();
     uint32_t peek() const { return peek_; }
     const std::string& str() const { return str_; }
     Loc loc() const { return {filename_, front_line_, front_col_, back_line_, back_col_}; }
 
-    std::istream& stream_;
+    std::istream* stream_ = nullptr;
+    const char* cur_ = nullptr; ///< Points behind the bytes of @p peek_ in buffer mode.
+    const char* end_ = nullptr;
     uint32_t peek_ = 0;
     char peek_bytes_[5] = {0, 0, 0, 0, 0};
     const char* filename_;
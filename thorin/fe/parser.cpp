@@ -1,7 +1,13 @@
 #include "thorin/fe/parser.h"
 
+#include <exception>
+#include <thread>
+
+#include "thorin/transform/import.h"
 #include "thorin/transform/reduce.h"
 #include "thorin/util/log.h"
+#include "thorin/util/mmap.h"
+#include "thorin/util/trace.h"
 
 namespace thorin::fe {
 
@@ -263,7 +269,7 @@ const Def* Parser::parse_literal() {
 Token Parser::next() {
     auto result = ahead();
     ahead_[0] = ahead_[1];
-    ahead_[1] = lexer_.lex();
+    ahead_[1] = lexer_->lex();
     return result;
 }
 
@@ -309,24 +315,7 @@ const Def* Parser::parse_identifier() {
         pop_scope();
     } else if (accept(TT::ColonColon)) { // id :: type := e; def
         // TODO parse multiple lets/nominals into one scope for mutual recursion and such
-        auto type = parse_def();
-        expect(TT::ColonEqual, "a nominal definition");
-
-        if (accept(TT::Lambda)) {
-            auto lambda = world_.lambda(type->as<Pi>(), tracker.loc()); // TODO properly set back location
-            insert_identifier(symbol, lambda);
-            Tracker tracker(this);
-            push_scope();
-            auto symbol = expect(TT::Identifier, "parameter name for nomimal λ").symbol();
-            insert_identifier(symbol, lambda->param({tracker.loc(), symbol}));
-            expect(TT::Dot, "λ abstraction");
-            auto body = parse_def();
-            pop_scope();
-            lambda->set(body);
-        } else {
-            assert(false && "TODO");
-        }
-
+        parse_nominal(tracker, symbol);
         eat(TT::Semicolon);
         push_scope();
         def = parse_def();
@@ -350,6 +339,73 @@ const Def* Parser::parse_identifier() {
     return def;
 }
 
+// type := λx. e
+const Def* Parser::parse_nominal(const Tracker& tracker, Symbol symbol) {
+    auto type = parse_def();
+    expect(TT::ColonEqual, "a nominal definition");
+
+    if (!type->isa<Pi>() || !accept(TT::Lambda))
+        error(tracker.loc(), "only nominal lambdas are supported but got '{}'", symbol);
+
+    auto lambda = world_.lambda(type->as<Pi>(), {tracker.loc(), symbol}); // TODO properly set back location
+    insert_identifier(symbol, lambda);
+    return parse_nominal_lambda(lambda);
+}
+
+// x. e
+Lambda* Parser::parse_nominal_lambda(Lambda* lambda) {
+    Tracker tracker(this);
+    push_scope();
+    auto symbol = expect(TT::Identifier, "parameter name for nomimal λ").symbol();
+    insert_identifier(symbol, lambda->param({tracker.loc(), symbol}));
+    expect(TT::Dot, "λ abstraction");
+    auto body = parse_def();
+    pop_scope();
+    return lambda->set(body);
+}
+
+// module ::= (x :: e := λx. e; | x :: e; | x = e;)* <eof>
+void Parser::parse_module() {
+    THORIN_TRACE("Parser::parse_module");
+    while (!ahead().isa(TT::Eof)) {
+        THORIN_TRACE("Parser::parse_def");
+        Tracker tracker(this);
+        auto symbol = expect(TT::Identifier, "a top-level definition").symbol();
+
+        if (accept(TT::ColonColon)) {
+            auto type = parse_def();
+            auto external = world_.lookup_external(symbol);
+            auto lambda = external ? external->isa_lambda() : nullptr;
+            if (external != nullptr && lambda == nullptr)
+                error(tracker.loc(), "redefinition of '{}'", symbol);
+
+            if (lambda == nullptr) {
+                if (!type->isa<Pi>())
+                    error(tracker.loc(), "only nominal lambdas are supported but got '{}'", symbol);
+                lambda = world_.lambda(type->as<Pi>(), {tracker.loc(), symbol});
+                world_.make_external(lambda);
+            } else if (lambda->type() != type) {
+                error(tracker.loc(), "type of '{}' does not match its declaration", symbol);
+            }
+
+            // a mere declaration unless followed by a body
+            if (accept(TT::ColonEqual)) {
+                if (lambda->body() != nullptr)
+                    error(tracker.loc(), "redefinition of '{}'", symbol);
+                if (!accept(TT::Lambda))
+                    error(tracker.loc(), "only nominal lambdas are supported but got '{}'", symbol);
+                insert_identifier(symbol, lambda);
+                parse_nominal_lambda(lambda);
+            }
+        } else {
+            expect(TT::Equal, "a top-level definition");
+            insert_identifier(symbol, parse_def());
+        }
+
+        expect(TT::Semicolon, "a top-level definition");
+    }
+}
+
 void Parser::push_debruijn_type(const Def* bruijn) {
     depth_++;
     debruijn_types_.push_back(bruijn);
@@ -457,9 +513,186 @@ void Parser::pop_scope() {
 //------------------------------------------------------------------------------
 
 const Def* parse(World& world, const char* str) {
+    THORIN_TRACE("Parser::parse_def");
     std::istringstream is(str, std::ios::binary);
     Lexer lexer(is, "stdin");
     return Parser(world, lexer).parse_def();
 }
 
+void parse_module(World& world, std::string_view buffer, const char* filename) {
+    Lexer lexer(buffer, filename);
+    Parser(world, lexer).parse_module();
+}
+
+void parse_module_file(World& world, const char* filename) {
+    MappedFile file(filename);
+    parse_module(world, file.view(), filename);
+}
+
+void parse_module_parallel(World& world, std::string_view buffer, const char* filename, size_t num_threads,
+                           const std::function<std::unique_ptr<World>()>& make_world) {
+    if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (num_threads == 1) return parse_module(world, buffer, filename);
+
+    // phase 1: split into chunks at top-level definitions and collect the declarations visible to subsequent chunks
+    struct Definition {
+        std::string_view text;
+        uint32_t line;
+        std::string_view name = {};
+        bool nominal = false; ///< @c x :: e := λx. e;
+    };
+    struct Chunk {
+        std::string_view text;
+        uint32_t line;
+        std::string prelude;
+        size_t first, last; ///< @p Definition%s of this chunk.
+    };
+
+    auto is_blank = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v'; };
+    std::vector<Definition> defs;
+    size_t def_begin = 0;
+    uint32_t line = 1, def_line = 1;
+    for (size_t i = 0, e = buffer.size(); i != e;) {
+        auto nl = buffer.find('\n', i);
+        if (nl == std::string_view::npos) break;
+        i = nl + 1;
+        ++line;
+        if (i != e && !is_blank(buffer[i])) {
+            defs.push_back({buffer.substr(def_begin, i - def_begin), def_line});
+            def_begin = i;
+            def_line = line;
+        }
+    }
+    if (def_begin != buffer.size())
+        defs.push_back({buffer.substr(def_begin), def_line});
+
+    // each piece must be a whole top-level definition - otherwise, a definition continues in the first column
+    auto is_definition = [&](Definition& def) {
+        auto end = def.text.find_last_not_of(" \t\r\n\f\v");
+        if (end == std::string_view::npos || def.text[end] != ';') return false;
+        Lexer lexer(def.text, filename);
+        if (!lexer.lex().isa(TT::Identifier)) return false;
+        auto tok = lexer.lex();
+        def.name = def.text.substr(0, def.text.find_first_of(" \t\r\n:="));
+        def.nominal = tok.isa(TT::ColonColon) && def.text.find(":=") != std::string_view::npos;
+        return tok.isa(TT::ColonColon) || tok.isa(TT::Equal);
+    };
+    if (!std::all_of(defs.begin(), defs.end(), is_definition))
+        return parse_module(world, buffer, filename);
+
+    // x :: e := λx. e;  ->  x :: e;
+    auto declaration = [&](std::string_view def) {
+        auto i = def.find_first_not_of(" \t\r\n", def.find_first_of(" \t\r\n:="));
+        if (i == std::string_view::npos || def.compare(i, 2, "::") != 0 || def.find(":=", i) == std::string_view::npos)
+            return std::string(def); // let or declaration
+        return std::string(def.substr(0, def.find(":=", i))) + ";\n";
+    };
+    auto for_each_identifier = [&](std::string_view text, auto f) {
+        Lexer lexer(text, filename);
+        for (auto tok = lexer.lex(); !tok.isa(TT::Eof); tok = lexer.lex()) {
+            if (tok.isa(TT::Identifier))
+                f(tok.symbol());
+        }
+    };
+
+    // The prelude of a chunk only declares those nominals of its predecessors the chunk refers to - transitively via their types.
+    // Lets and mere declarations are always replayed.
+    std::vector<Chunk> chunks;
+    SymbolMap<size_t> nominals; ///< Nominal definitions of the preceding chunks.
+    std::vector<size_t> lets;
+    std::vector<Symbol> let_ids;
+    auto target = buffer.size() / num_threads + 1;
+    for (size_t d = 0, e = defs.size(); d != e;) {
+        size_t first = d, size = 0;
+        do {
+            size += defs[d++].text.size();
+        } while (d != e && size < target);
+        std::string_view text(defs[first].text.data(), size);
+
+        HashSet<Symbol> referenced;
+        std::vector<Symbol> stack;
+        auto refer = [&](Symbol id) {
+            if (referenced.emplace(id).second)
+                stack.emplace_back(id);
+        };
+        for_each_identifier(text, refer);
+        for (auto id : let_ids)
+            refer(id);
+
+        std::vector<size_t> replay = lets;
+        while (!stack.empty()) {
+            if (auto i = nominals.find(pop(stack)); i != nominals.end()) {
+                replay.emplace_back(i->second);
+                for_each_identifier(declaration(defs[i->second].text), refer);
+            }
+        }
+        std::sort(replay.begin(), replay.end());
+
+        std::string prelude;
+        for (auto j : replay)
+            prelude.append(declaration(defs[j].text));
+        chunks.push_back({text, defs[first].line, std::move(prelude), first, d});
+
+        for (size_t j = first; j != d; ++j) {
+            if (defs[j].nominal) {
+                nominals[Symbol(defs[j].name)] = j;
+            } else {
+                lets.emplace_back(j);
+                for_each_identifier(defs[j].text, [&](Symbol id) { let_ids.emplace_back(id); });
+            }
+        }
+    }
+
+    // phase 2: parse each chunk into its own World
+    std::vector<std::unique_ptr<World>> worlds(chunks.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    std::vector<std::thread> threads;
+    for (size_t k = 0, e = chunks.size(); k != e; ++k) {
+        threads.emplace_back([&, k] {
+            try {
+                auto& chunk = chunks[k];
+                worlds[k] = make_world();
+                Lexer prelude_lexer(chunk.prelude, filename);
+                Parser parser(*worlds[k], prelude_lexer);
+                parser.parse_module();
+                Lexer lexer(chunk.text, filename, chunk.line);
+                parser.resume(lexer);
+                parser.parse_module();
+            } catch (...) {
+                errors[k] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    // phase 3: merge in order such that each chunk finds the externals of its predecessors
+    auto is_set = [](const Def* def) { return std::all_of(def->ops().begin(), def->ops().end(), [](auto op) { return op != nullptr; }); };
+    // the Debug of a nominal stems from its first declaration which may be a prelude - so look up the definition in the buffer
+    auto definition_loc = [&](Symbol name, size_t first, size_t last) {
+        for (size_t d = first; d != last; ++d) {
+            if (defs[d].nominal && defs[d].name == name.c_str())
+                return Loc(filename, defs[d].line, 1);
+        }
+        return Loc();
+    };
+    for (size_t k = 0, e = worlds.size(); k != e; ++k) {
+        auto importer = Importer::into(world);
+        std::vector<const Def*> externals;
+        for (auto [name, def] : worlds[k]->externals()) {
+            // the prelude of a chunk only declares the nominals of its predecessors - so a set one is defined in this chunk
+            if (auto prev = world.lookup_external(name); prev != nullptr && prev->is_nominal() && is_set(prev) && is_set(def))
+                Parser::error(definition_loc(name, chunks[k].first, chunks[k].last),
+                              "redefinition of '{}' - previous definition at {}", name, definition_loc(name, 0, chunks[k].first));
+            externals.emplace_back(def);
+        }
+        std::sort(externals.begin(), externals.end(), [](const Def* a, const Def* b) { return a->gid() < b->gid(); });
+        for (auto def : externals)
+            world.make_external(importer.import(def));
+    }
+}
+
 }
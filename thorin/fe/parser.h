@@ -2,6 +2,9 @@
 #define THORIN_FE_PARSER_H
 
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <string_view>
 
 #include "thorin/def.h"
 #include "thorin/world.h"
@@ -16,13 +19,33 @@ class Parser {
 public:
     Parser(World& world, Lexer& lexer)
         : world_(world)
-        , lexer_(lexer)
+        , lexer_(&lexer)
     {
-        ahead_[0] = lexer_.lex();
-        ahead_[1] = lexer_.lex();
+        ahead_[0] = lexer_->lex();
+        ahead_[1] = lexer_->lex();
     }
 
     const Def* parse_def();
+    /// Parses a sequence of top-level definitions.
+    /// Nominals become externals of the @p World; lets are visible to all subsequent definitions.
+    /// Each definition is constructed right away - only the next two @p Token%s are buffered.
+    void parse_module();
+    /// Continues with @p lexer once the current one is exhausted; all top-level definitions parsed so far stay visible.
+    void resume(Lexer& lexer) {
+        assert(ahead().isa(TT::Eof));
+        lexer_ = &lexer;
+        ahead_[0] = lexer_->lex();
+        ahead_[1] = lexer_->lex();
+    }
+
+    /// Throws a @c std::logic_error reporting a parse error at @p loc.
+    template<typename... Args>
+    [[noreturn]] static void error(Loc loc, const char* fmt, Args... args) {
+        std::ostringstream oss;
+        streamf(oss, "{}: parse error: ", loc);
+        streamf(oss, fmt, std::forward<Args>(args)...);
+        throw std::logic_error(oss.str());
+    }
 
 private:
     struct Tracker {
@@ -35,7 +58,7 @@ private:
         Loc loc() const {
             auto back_line = parser.ahead_[0].loc().back_line();
             auto back_col  = parser.ahead_[0].loc().back_col();
-            return {parser.lexer_.filename(), line, col, back_line, back_col};
+            return {parser.lexer_->filename(), line, col, back_line, back_col};
         }
 
         const Parser& parser;
@@ -59,6 +82,8 @@ private:
     const Def* parse_extract_or_insert(Tracker, const Def*);
     const Def* parse_literal();
     const Def* parse_identifier();
+    const Def* parse_nominal(const Tracker&, Symbol);
+    Lambda* parse_nominal_lambda(Lambda*);
 
     DefVector parse_list(Token::Tag end, Token::Tag sep, const char* context, std::function<const Def*()> f) {
         DefVector elems;
@@ -136,17 +161,10 @@ private:
     void push_scope();
     void pop_scope();
     template<typename... Args>
-    [[noreturn]] void error(Loc loc, const char* fmt, Args... args) {
-        std::ostringstream oss;
-        streamf(oss, "{}: parse error: ", loc);
-        streamf(oss, fmt, std::forward<Args>(args)...);
-        throw std::logic_error(oss.str());
-    }
-    template<typename... Args>
     [[noreturn]] void error(const char* fmt, Args... args) { error(ahead().loc(), fmt, std::forward<Args>(args)...); }
 
     World& world_;
-    Lexer& lexer_;
+    Lexer* lexer_;
 
     Token ahead_[2];
 
@@ -161,6 +179,23 @@ private:
 };
 
 const Def* parse(World& world, const char* str);
+void parse_module(World& world, std::string_view buffer, const char* filename = "stdin");
+void parse_module_file(World& world, const char* filename); ///< Memory-maps @p filename and lexes it in buffer mode.
+
+/**
+ * @attention { Experimental: this is @em not faster than @p parse_module yet. }
+ * Parses a module on @p num_threads threads.
+ * Each top-level definition should start in the first column of a line - continuation lines are indented.
+ * The definitions are split into one chunk per thread; each chunk is parsed into its own @p World created by @p make_world.
+ * In front of each chunk, all lets and the signatures of those nominals of the preceding chunks the chunk refers to are replayed.
+ * Thus, each let is parsed again in every subsequent chunk - up to @p num_threads times in total.
+ * Finally, all chunks are merged into @p world via the @p Importer in order.
+ * This sequential merge rebuilds every Def once more and costs more than parsing the whole module sequentially
+ * (see @c BM_parse_module_parallel).
+ * If a definition continues in the first column, this falls back to @p parse_module.
+ */
+void parse_module_parallel(World& world, std::string_view buffer, const char* filename, size_t num_threads,
+                           const std::function<std::unique_ptr<World>()>& make_world = [] { return std::make_unique<World>(); });
 
 }
 
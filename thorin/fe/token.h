@@ -88,7 +88,7 @@ public:
         , loc_(loc)
         , literal_(lit)
     {}
-    Token(Loc loc, const std::string& identifier)
+    Token(Loc loc, Symbol identifier)
         : tag_(Tag::Identifier)
         , loc_(loc)
         , symbol_(identifier)
@@ -0,0 +1,59 @@
+#include "thorin/free_vars.h"
+
+namespace thorin {
+
+const FreeVars& FreeVars::empty() {
+    static const FreeVars empty{BitSet()};
+    return empty;
+}
+
+const FreeVars* FreeVarsTable::intern(BitSet&& bits) {
+    FreeVars key(std::move(bits));
+    if (key.none())
+        return &FreeVars::empty();
+    if (auto i = sets_.find(&key); i != sets_.end())
+        return *i;
+
+    auto result = &storage_.emplace_back(BitSet(key.bits()));
+    sets_.emplace(result);
+    return result;
+}
+
+const FreeVars* FreeVarsTable::var(size_t index) {
+    static const size_t Cached = 64;
+    if (index < vars_.size() && vars_[index] != nullptr)
+        return vars_[index];
+
+    auto result = intern(std::move(BitSet().set(index)));
+    if (index < Cached) {
+        if (vars_.size() <= index)
+            vars_.resize(Cached);
+        vars_[index] = result;
+    }
+    return result;
+}
+
+const FreeVars* FreeVarsTable::shift(const FreeVars* fv, size_t shift) {
+    if (shift == 0 || fv->none())
+        return fv;
+    if (fv->max() < shift)
+        return &FreeVars::empty();
+
+    auto [i, inserted] = shifts_.emplace(std::pair(fv, shift), nullptr);
+    if (inserted)
+        i->second = intern(std::move(BitSet().or_shr(fv->bits(), shift)));
+    return i->second;
+}
+
+const FreeVars* FreeVarsTable::unite(const FreeVars* fv1, const FreeVars* fv2) {
+    if (fv1 == fv2 || fv2->none()) return fv1;
+    if (fv1->none()) return fv2;
+    if (fv2 < fv1) std::swap(fv1, fv2); // union is commutative
+
+    auto [i, inserted] = unions_.emplace(std::pair(fv1, fv2), nullptr);
+    if (inserted)
+        i->second = intern(std::move(BitSet(fv1->bits()) |= fv2->bits()));
+    return i->second;
+}
+
+}
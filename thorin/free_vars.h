@@ -0,0 +1,122 @@
+#ifndef THORIN_FREE_VARS_H
+#define THORIN_FREE_VARS_H
+
+#include <deque>
+#include <utility>
+
+#include "thorin/util/bitset.h"
+#include "thorin/util/hash.h"
+
+namespace thorin {
+
+/**
+ * An immutable set of the De Bruijn indices of the free @p Var%s of a @p Def.
+ * These sets repeat heavily across @p Def%s.
+ * Hence, each @p World interns them in its @p FreeVarsTable and a @p Def merely points to its set.
+ * The lowest and highest index are cached such that the usual queries - any free var below/above some index? - are O(1).
+ */
+class FreeVars {
+public:
+    FreeVars(const FreeVars&) = delete;
+    FreeVars& operator=(const FreeVars&) = delete;
+
+    FreeVars(BitSet&& bits)
+        : bits_(std::move(bits))
+        , min_(bits_.find_first())
+        , max_(bits_.find_last())
+        , hash_(bits_.hash())
+    {}
+
+    static const FreeVars& empty(); ///< Shared by all @p World%s.
+
+    const BitSet& bits() const { return bits_; }
+    /// lowest/highest index - @c size_t(-1) if empty
+    size_t min() const { return min_; }
+    size_t max() const { return max_; }
+    uint64_t hash() const { return hash_; }
+
+    bool test(size_t i) const { return min_ <= i && i <= max_ && bits_.test(i); }
+
+    /// @name any
+    //@{
+    /// Is any index in @c [begin,end[ free?
+    bool any_range(size_t begin, size_t end) const {
+        if (none()) return false;
+        begin = std::max(begin, min_);
+        end   = std::min(end, max_ + 1);
+        if (begin >= end) return false;
+        return begin == min_ || end == max_ + 1 || bits_.any_range(begin, end);
+    }
+    bool any_end(size_t end) const { return min_ < end; }
+    bool any_begin(size_t begin) const { return !none() && max_ >= begin; }
+    bool any() const { return !none(); }
+    //@}
+
+    /// @name none
+    //@{
+    bool none_range(size_t begin, size_t end) const { return !any_range(begin, end); }
+    bool none_end(size_t end) const { return !any_end(end); }
+    bool none_begin(size_t begin) const { return !any_begin(begin); }
+    bool none() const { return min_ == size_t(-1); }
+    //@}
+
+    bool intersects(const BitSet& other) const { return bits_.intersects(other); }
+
+private:
+    BitSet bits_;
+    size_t min_;
+    size_t max_;
+    uint64_t hash_;
+};
+
+/**
+ * Hash-conses the @p FreeVars of a @p World.
+ * The results of @p shift and @p unite are memoized such that @p Def::finalize mostly boils down to a few lookups.
+ */
+class FreeVarsTable {
+public:
+    FreeVarsTable(const FreeVarsTable&) = delete;
+    FreeVarsTable& operator=(const FreeVarsTable&) = delete;
+
+    FreeVarsTable() {}
+
+    const FreeVars* var(size_t index);                             ///< @c {index}
+    const FreeVars* shift(const FreeVars*, size_t shift);          ///< Drops all indices below @p shift and subtracts @p shift from the others.
+    const FreeVars* unite(const FreeVars*, const FreeVars*);
+    size_t size() const { return sets_.size(); }
+
+    friend void swap(FreeVarsTable& t1, FreeVarsTable& t2) {
+        using std::swap;
+        swap(t1.storage_, t2.storage_);
+        swap(t1.sets_,    t2.sets_);
+        swap(t1.vars_,    t2.vars_);
+        swap(t1.shifts_,  t2.shifts_);
+        swap(t1.unions_,  t2.unions_);
+    }
+
+private:
+    const FreeVars* intern(BitSet&&);
+
+    struct SetHash {
+        static uint64_t hash(const FreeVars* fv) { return fv->hash(); }
+        static bool eq(const FreeVars* fv1, const FreeVars* fv2) { return fv1->bits() == fv2->bits(); }
+        static const FreeVars* sentinel() { return (const FreeVars*)(1); }
+    };
+
+    template<class T>
+    struct PairHash {
+        static uint64_t hash(std::pair<const FreeVars*, T> p) { return murmur3(hash_combine(hash_begin(p.first), p.second)); }
+        static bool eq(std::pair<const FreeVars*, T> p1, std::pair<const FreeVars*, T> p2) { return p1 == p2; }
+        static std::pair<const FreeVars*, T> sentinel() { return {nullptr, T()}; }
+    };
+
+    std::deque<FreeVars> storage_;
+    HashSet<const FreeVars*, SetHash> sets_;
+    std::vector<const FreeVars*> vars_;
+    HashMap<std::pair<const FreeVars*, size_t>, const FreeVars*, PairHash<size_t>> shifts_;
+    HashMap<std::pair<const FreeVars*, const FreeVars*>, const FreeVars*, PairHash<const FreeVars*>> unions_;
+};
+
+}
+
+#endif
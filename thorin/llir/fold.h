@@ -11,17 +11,32 @@ namespace thorin::llir {
 
 struct BottomException {};
 
+/**
+ * Folds @p a and @p b with @p f at width @p w.
+ * @p f must behave like @c __builtin_add_overflow and friends: store the wrapped result and report whether the exact result doesn't fit.
+ * Yields the wrapped unsigned result or throws a @p BottomException if @p nsw (@p nuw) is set and the signed (unsigned) operation overflows.
+ */
+template<int w, bool nsw, bool nuw, class F>
+Box fold_overflow(Box a, Box b, F f) {
+    typedef typename w2u<w>::type UT;
+    typedef typename w2s<w>::type ST;
+    auto x = a.template get<UT>();
+    auto y = b.template get<UT>();
+    UT ures;
+    if (f(x, y, &ures) && nuw) throw BottomException();
+    if constexpr (nsw) {
+        ST sres;
+        if (f(ST(x), ST(y), &sres)) throw BottomException();
+    }
+    return {ures};
+}
+
 template<WOp> struct FoldWOp {};
 
 template<> struct FoldWOp<WOp::add> {
     template<int w, bool nsw, bool nuw> struct Fold {
         static Box run(Box a, Box b) {
-            auto x = a.template get<typename w2u<w>::type>();
-            auto y = b.template get<typename w2u<w>::type>();
-            decltype(x) res = x + y;
-            if (nuw && res < x) throw BottomException();
-            // TODO nsw
-            return {res};
+            return fold_overflow<w, nsw, nuw>(a, b, [](auto x, auto y, auto* res) { return __builtin_add_overflow(x, y, res); });
         }
     };
 };
@@ -29,13 +44,7 @@ template<> struct FoldWOp<WOp::add> {
 template<> struct FoldWOp<WOp::sub> {
     template<int w, bool nsw, bool nuw> struct Fold {
         static Box run(Box a, Box b) {
-            typedef typename w2u<w>::type UT;
-            auto x = a.template get<UT>();
-            auto y = b.template get<UT>();
-            decltype(x) res = x - y;
-            //if (nuw && y && x > std::numeric_limits<UT>::max() / y) throw BottomException();
-            // TODO nsw
-            return {res};
+            return fold_overflow<w, nsw, nuw>(a, b, [](auto x, auto y, auto* res) { return __builtin_sub_overflow(x, y, res); });
         }
     };
 };
@@ -43,26 +52,23 @@ template<> struct FoldWOp<WOp::sub> {
 template<> struct FoldWOp<WOp::mul> {
     template<int w, bool nsw, bool nuw> struct Fold {
         static Box run(Box a, Box b) {
-            typedef typename w2u<w>::type UT;
-            auto x = a.template get<UT>();
-            auto y = b.template get<UT>();
-            decltype(x) res = x * y;
-            if (nuw && y && x > std::numeric_limits<UT>::max() / y) throw BottomException();
-            // TODO nsw
-            return {res};
+            return fold_overflow<w, nsw, nuw>(a, b, [](auto x, auto y, auto* res) { return __builtin_mul_overflow(x, y, res); });
         }
     };
 };
 
+// Like LLVM: shifting by w or more yields bottom; nuw (nsw) yields bottom if any shifted out bit is set (differs from the sign bit).
 template<> struct FoldWOp<WOp::shl> {
     template<int w, bool nsw, bool nuw> struct Fold {
         static Box run(Box a, Box b) {
             typedef typename w2u<w>::type UT;
+            typedef typename w2s<w>::type ST;
             auto x = a.template get<UT>();
             auto y = b.template get<UT>();
-            decltype(x) res = x << y;
-            //if (nuw && y && x > std::numeric_limits<UT>::max() / y) throw BottomException();
-            // TODO nsw
+            if (y >= UT(w)) throw BottomException();
+            UT res = x << y;
+            if (nuw && UT(res >> y) != x) throw BottomException();
+            if (nsw && ST(ST(res) >> y) != ST(x)) throw BottomException();
             return {res};
         }
     };
@@ -42,59 +42,87 @@ bool is_commutative(IOp op) { return op == IOp::iand || op == IOp:: ior || op ==
 bool is_commutative(FOp op) { return op == FOp::fadd || op == FOp::fmul; }
 
 /*
- * WArithop
+ * folding kernels
+ *
+ * The kernel for an op-head - the callee of a fully applied op - is looked up in a dispatch table on the first fold and
+ * cached in the App afterwards. Every further fold with the same op, flags and width is a single indirect call.
  */
 
-template<template<int, bool, bool> class F>
-static const Def* try_wfold(const Def* callee, const Def* a, const Def* b, Debug dbg) {
-    auto& world = static_cast<World&>(callee->world());
+/// Looks up the kernel for bit width @p w in a @p table which starts with width @p min - @c nullptr if unsupported.
+template<size_t N>
+static App::Fold lookup_width(const std::array<App::Fold, N>& table, s64 w, s64 min) {
+    if (w < min || !is_power_of_2(w)) return nullptr;
+    auto i = log2(w) - log2(min);
+    return i < N ? table[i] : nullptr;
+}
+
+/// The cached kernel of the op-head @p callee - @p select picks it on the first call.
+static App::Fold get_fold(const Def* callee, App::Fold (*select)(const App*)) {
+    auto head = callee->as<App>();
+    if (auto fold = head->fold()) return fold;
+    auto fold = select(head);
+    if (fold != nullptr)
+        head->set_fold(fold);
+    return fold;
+}
+
+/// Folds the @p Lit%s @p a and @p b with the kernel of @p callee - yields @c nullptr if this is not possible.
+static const Def* run_fold(const Def* callee, const Def* a, const Def* b, App::Fold (*select)(const App*)) {
     auto la = a->isa<Lit>(), lb = b->isa<Lit>();
     if (la && lb) {
-        auto ba = la->box(), bb = lb->box();
-        auto t = callee->type()->template as<Pi>()->codomain();
-        auto fw = app_arg(app_callee(callee));
-        auto f = get_nat(world.extract(fw, 0_u64));
-        auto w = get_nat(world.extract(fw, 1_u64));
+        auto& world = callee->world();
+        auto t = callee->type()->as<Pi>()->codomain();
+        auto fold = get_fold(callee, select);
+        if (fold == nullptr) return nullptr;
         try {
-            switch (f) {
-                case int64_t(WFlags::none):
-                    switch (w) {
-                        case  8: return world.lit(t, F< 8, false, false>::run(ba, bb));
-                        case 16: return world.lit(t, F<16, false, false>::run(ba, bb));
-                        case 32: return world.lit(t, F<32, false, false>::run(ba, bb));
-                        case 64: return world.lit(t, F<64, false, false>::run(ba, bb));
-                        default: THORIN_UNREACHABLE;
-                    }
-                case int64_t(WFlags::nsw):
-                    switch (w) {
-                        case  8: return world.lit(t, F< 8,  true, false>::run(ba, bb));
-                        case 16: return world.lit(t, F<16,  true, false>::run(ba, bb));
-                        case 32: return world.lit(t, F<32,  true, false>::run(ba, bb));
-                        case 64: return world.lit(t, F<64,  true, false>::run(ba, bb));
-                        default: THORIN_UNREACHABLE;
-                    }
-                case int64_t(WFlags::nuw):
-                    switch (w) {
-                        case  8: return world.lit(t, F< 8, false,  true>::run(ba, bb));
-                        case 16: return world.lit(t, F<16, false,  true>::run(ba, bb));
-                        case 32: return world.lit(t, F<32, false,  true>::run(ba, bb));
-                        case 64: return world.lit(t, F<64, false,  true>::run(ba, bb));
-                        default: THORIN_UNREACHABLE;
-                    }
-                case int64_t(WFlags::nsw | WFlags::nuw):
-                    switch (w) {
-                        case  8: return world.lit(t, F< 8,  true,  true>::run(ba, bb));
-                        case 16: return world.lit(t, F<16,  true,  true>::run(ba, bb));
-                        case 32: return world.lit(t, F<32,  true,  true>::run(ba, bb));
-                        case 64: return world.lit(t, F<64,  true,  true>::run(ba, bb));
-                        default: THORIN_UNREACHABLE;
-                    }
-            }
+            return world.lit(t, fold(la->box(), lb->box()));
         } catch (BottomException) {
             return world.bot(t);
         }
     }
 
+    return nullptr;
+}
+
+/// Kernels with flags and width: <tt>Π[f: nat, w: nat]</tt> with @p WFlags.
+template<template<int, bool, bool> class F>
+static App::Fold select_wfold(const App* head) {
+    static const std::array<App::Fold, 4> tables[4] = {
+        {{ F< 8, false, false>::run, F<16, false, false>::run, F<32, false, false>::run, F<64, false, false>::run }}, // none
+        {{ F< 8,  true, false>::run, F<16,  true, false>::run, F<32,  true, false>::run, F<64,  true, false>::run }}, // nsw
+        {{ F< 8, false,  true>::run, F<16, false,  true>::run, F<32, false,  true>::run, F<64, false,  true>::run }}, // nuw
+        {{ F< 8,  true,  true>::run, F<16,  true,  true>::run, F<32,  true,  true>::run, F<64,  true,  true>::run }}, // nsw | nuw
+    };
+    auto& world = head->world();
+    auto fw = app_arg(app_callee(head));
+    auto f = get_nat(world.extract(fw, 0_u64));
+    auto w = get_nat(world.extract(fw, 1_u64));
+    assert(0 <= f && f <= int64_t(WFlags::nsw | WFlags::nuw));
+    return lookup_width(tables[f], w, 8);
+}
+
+/// Integer kernels with width only: <tt>Πw: nat</tt>.
+template<template<int> class F>
+static App::Fold select_ifold(const App* head) {
+    static const std::array<App::Fold, 4> table = {{ F<8>::run, F<16>::run, F<32>::run, F<64>::run }};
+    return lookup_width(table, get_nat(app_arg(app_callee(head))), 8);
+}
+
+/// Floating-point kernels with flags and width: <tt>Π[f: nat, w: nat]</tt> with @p FFlags - the flags don't affect folding.
+template<template<int> class F>
+static App::Fold select_rfold(const App* head) {
+    static const std::array<App::Fold, 3> table = {{ F<16>::run, F<32>::run, F<64>::run }};
+    auto& world = head->world();
+    return lookup_width(table, get_nat(world.extract(app_arg(app_callee(head)), 1_u64)), 16);
+}
+
+/*
+ * WArithop
+ */
+
+template<template<int, bool, bool> class F>
+static const Def* try_wfold(const Def* callee, const Def* a, const Def* b, Debug dbg) {
+    if (auto result = run_fold(callee, a, b, select_wfold<F>)) return result;
     return normalize_tuple(callee, {a, b}, dbg);
 }
 
@@ -144,25 +172,7 @@ const Def* normalize_WOp(const Def* callee, const Def* arg, Debug dbg) {
 
 template<template<int> class F>
 static const Def* just_try_ifold(const Def* callee, const Def* a, const Def* b) {
-    auto& world = static_cast<World&>(callee->world());
-    auto la = a->isa<Lit>(), lb = b->isa<Lit>();
-    if (la && lb) {
-        auto ba = la->box(), bb = lb->box();
-        auto t = callee->type()->template as<Pi>()->codomain();
-        auto w = get_nat(app_arg(app_callee(callee)));
-        try {
-            switch (w) {
-                case  8: return world.lit(t, F< 8>::run(ba, bb));
-                case 16: return world.lit(t, F<16>::run(ba, bb));
-                case 32: return world.lit(t, F<32>::run(ba, bb));
-                case 64: return world.lit(t, F<64>::run(ba, bb));
-            }
-        } catch (BottomException) {
-            return world.bot(t);
-        }
-    }
-
-    return nullptr;
+    return run_fold(callee, a, b, select_ifold<F>);
 }
 
 template<template<int> class F>
@@ -229,23 +239,7 @@ const Def* normalize_IOp(const Def* callee, const Def* arg, Debug dbg) {
 
 template<template<int> class F>
 static const Def* try_rfold(const Def* callee, const Def* a, const Def* b, Debug dbg) {
-    auto& world = static_cast<World&>(callee->world());
-    auto la = a->isa<Lit>(), lb = b->isa<Lit>();
-    if (la && lb) {
-        auto ba = la->box(), bb = lb->box();
-        auto t = callee->type()->template as<Pi>()->codomain();
-        auto w = get_nat(world.extract(app_arg(app_callee(callee)), 1));
-        try {
-            switch (w) {
-                case 16: return world.lit(t, F<16>::run(ba, bb));
-                case 32: return world.lit(t, F<32>::run(ba, bb));
-                case 64: return world.lit(t, F<64>::run(ba, bb));
-            }
-        } catch (BottomException) {
-            return world.bot(t);
-        }
-    }
-
+    if (auto result = run_fold(callee, a, b, select_rfold<F>)) return result;
     return normalize_tuple(callee, {a, b}, dbg);
 }
 
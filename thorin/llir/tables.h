@@ -1,6 +1,7 @@
 #ifndef THORIN_LLIR_TABLES_H
 #define THORIN_LLIR_TABLES_H
 
+#include "thorin/tables.h"
 #include "thorin/util/utility.h"
 
 namespace thorin::llir {
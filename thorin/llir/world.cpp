@@ -25,8 +25,8 @@ std::array<const Def*, 2> infer_width_and_shape(World& world, const Def* def) {
 
 //------------------------------------------------------------------------------
 
-World::World(Debug dbg)
-    : thorin::World(dbg)
+World::World(Bootstrap, Debug dbg)
+    : thorin::World(thorin::World::prelude(), dbg)
 {
     type_i_     = axiom("int", "Πnat. *");
     type_f_     = axiom("float", "Πnat. *");
@@ -69,6 +69,43 @@ World::World(Debug dbg)
     cn_pe_info_ = axiom("pe_info", "cn[T: *, ptr(int 8s64::nat, 0s64::nat), T, cn[]]");
 }
 
+World::World(const World& prelude, Debug dbg)
+    : thorin::World(prelude, dbg)
+{
+    type_i_     = lookup_axiom("int");
+    type_f_     = lookup_axiom("float");
+    type_ptr_   = lookup_axiom("ptr");
+    type_mem_   = lookup_axiom("M");
+    type_frame_ = lookup_axiom("F");
+    type_dbz_   = lookup_axiom("Z");
+
+#define CODE(T, o) \
+    T ## _[size_t(T::o)] = lookup_axiom(op2str(T::o));
+    THORIN_W_OP (CODE)
+    THORIN_Z_OP (CODE)
+    THORIN_I_OP (CODE)
+    THORIN_F_OP (CODE)
+    THORIN_I_CMP(CODE)
+    THORIN_F_CMP(CODE)
+#undef CODE
+#define CODE(T, o) \
+    T ## _[size_t(T::o)] = lookup_axiom(cast2str(T::o));
+    THORIN_CAST(CODE)
+#undef CODE
+
+    op_lea_     = lookup_axiom("lea");
+    op_load_    = lookup_axiom("load");
+    op_store_   = lookup_axiom("store");
+    op_enter_   = lookup_axiom("enter");
+    op_slot_    = lookup_axiom("slot");
+    cn_pe_info_ = lookup_axiom("pe_info");
+}
+
+const World& World::prelude() {
+    static const World prelude(Bootstrap{});
+    return prelude;
+}
+
 static const Def* get_addr_space(const Def* mem) {
     return mem->type()->as<App>()->arg();
 }
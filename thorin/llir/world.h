@@ -14,7 +14,12 @@ std::array<const Def*, 2> infer_width_and_shape(World&, const Def*);
 
 class World : public ::thorin::World {
 public:
-    World(Debug dbg = {});
+    World(Debug dbg = {}) : World(prelude(), dbg) {}
+    World(const World& prelude, Debug dbg);
+    /// Copies the built-in Def%s of thorin::World::prelude and parses the LLIR types on top.
+    World(Bootstrap, Debug dbg = {});
+
+    static const World& prelude();
 
     //@{ types and type constructors
     const Axiom* type_i() { return type_i_; }
@@ -133,6 +138,8 @@ public:
     //@}
 
     //@{ memory operations
+    const Axiom* op_load() { return op_load_; }
+    const Axiom* op_store() { return op_store_; }
     const Def* op_alloc(const Def* type, const Def* mem, Debug dbg = {});
     const Def* op_alloc(const Def* type, const Def* mem, const Def* extra, Debug dbg = {});
     const Def* op_enter(const Def* mem, Debug dbg = {});
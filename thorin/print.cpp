@@ -1,5 +1,8 @@
 #include "thorin/print.h"
 
+#include <charconv>
+#include <thread>
+
 #include "thorin/def.h"
 
 namespace thorin {
@@ -26,20 +29,9 @@ DefPrinter& Def::name_stream(DefPrinter& os) const {
 #endif
 
 std::string DefPrinter::str(const Def* def) const {
-    if (descend(def))
-        return def->unique_name();
-
-    std::ostringstream os;
-    DefPrinter printer(os, tab());
-    def->stream(printer);
-    return os.str();
-#if 0
-    if (is_nominal()) {
-        qualifier_stream(os);
-        return os << name();
-    }
-    return vstream(os);
-#endif
+    DefWriter writer(nullptr, tab());
+    writer.ref(def);
+    return std::move(writer.buffer());
 }
 
 
@@ -112,184 +104,352 @@ DefPrinter& DefPrinter::recurse(const Def* def) {
 
 //------------------------------------------------------------------------------
 
-DefPrinter& Def::qualifier_stream(DefPrinter& p) const {
-    if (!has_values() || is_type_qualifier(this))
-        return p;
-    if (type()->is_kind()) {
-        auto q = type()->op(0);
-        if (auto qual = get_qualifier(q)) {
-            if (qual != Qualifier::u)
-                q->stream(p);
-        } else
-            q->stream(p);
+void DefWriter::flush() {
+    if (ostream_ != nullptr) {
+        ostream_->write(buffer_.data(), buffer_.size());
+        buffer_.clear();
     }
-    return p;
 }
 
-DefPrinter& Def::stream_assign(DefPrinter& p) const {
-    return stream(streamf(p, "{}: {} = ", unique_name(), type()));
+void DefWriter::put(u64 val) {
+    char buf[20];
+    auto res = std::to_chars(buf, buf + sizeof(buf), val);
+    buffer_.append(buf, res.ptr);
 }
 
-void Def::dump_assign() const {
-    DefPrinter printer;
-    stream_assign(printer).endl();
+void DefWriter::endl() {
+    put('\n');
+    for (int i = 0; i != level_; ++i) put(tab_);
+    if (buffer_.size() >= FlushSize) flush();
 }
 
-void Def::dump_rec() const {
-    DefPrinter p;
-    p.recurse(this).endl();
+void DefWriter::unique_name(const Def* def) {
+    put(def->name().view());
+    put('_');
+    put(u64(def->gid()));
 }
 
-//------------------------------------------------------------------------------
-
-DefPrinter& App::stream(DefPrinter& p) const {
-    streamf(p, "{}", p.str(callee()));
-
-    if (arg()->isa<Tuple>() || arg()->isa<Pack>())
-        return arg()->stream(p << ' ');
-    return streamf(p, " {}", p.str(arg()));
-
-#if 0
-    auto domain = callee_type();
-    if (domain->is_kind()) {
-        qualifier_stream(p);
+void DefWriter::qualifier(const Def* def) {
+    if (!def->has_values() || is_type_qualifier(def))
+        return;
+    if (def->type()->is_kind()) {
+        auto q = def->type()->op(0);
+        if (auto qual = get_qualifier(q)) {
+            if (qual != Qualifier::u)
+                stream(q);
+        } else
+            stream(q);
     }
-    callee()->name_stream(p);
-    if (!arg()->isa<Tuple>() && !arg()->isa<Pack>())
-        p << "(";
-    arg()->name_stream(p);
-    if (!arg()->isa<Tuple>() && !arg()->isa<Pack>())
-        p << ")";
-#endif
 }
 
-DefPrinter& Axiom::stream(DefPrinter& p) const {
-    return qualifier_stream(p) << name();
+void DefWriter::ref(const Def* def) {
+    if (def == nullptr)
+        put("<null>");
+    else if (descend(def))
+        unique_name(def);
+    else
+        stream(def);
 }
 
-DefPrinter& BotTop::stream(DefPrinter& p) const { return streamf(p, "{{⊥: {}}}", p.str(type())); }
-
-DefPrinter& Extract::stream(DefPrinter& p) const {
-    return streamf(p, "{}#{}", p.str(scrutinee()), p.str(index()));
-#if 0
-    return scrutinee()->name_stream(p) << "#" << index();
-#endif
+void DefWriter::list(Defs defs, std::string_view sep) {
+    for (size_t i = 0, e = defs.size(); i != e; ++i) {
+        if (i != 0) put(sep);
+        ref(defs[i]);
+    }
 }
 
-DefPrinter& Insert::stream(DefPrinter& p) const {
-    return streamf(p, "{}#{} <- ", p.str(scrutinee()), p.str(index()), p.str(value()));
-#if 0
-    return scrutinee()->name_stream(p) << "." << index() << "=" << value();
-#endif
-}
+void DefWriter::stream(const Def* def) {
+    if (def == nullptr) return put("<null>");
 
-DefPrinter& Intersection::stream(DefPrinter& p) const {
-    return streamf(qualifier_stream(p), "({ ∩ })", p.list(ops()));
+    switch (def->tag()) {
+        case Def::Tag::App: {
+            auto app = def->as<App>();
+            ref(app->callee());
+            put(' ');
+            if (app->arg()->isa<Tuple>() || app->arg()->isa<Pack>())
+                return stream(app->arg());
+            return ref(app->arg());
+        }
+        case Def::Tag::Axiom:
+            qualifier(def);
+            return put(def->name().view());
+        case Def::Tag::Bot:
+        case Def::Tag::Top:
+            put("{⊥: ");
+            ref(def->type());
+            return put('}');
+        case Def::Tag::Extract:
+            ref(def->as<Extract>()->scrutinee());
+            put('#');
+            return ref(def->as<Extract>()->index());
+        case Def::Tag::Insert:
+            ref(def->as<Insert>()->scrutinee());
+            put('#');
+            ref(def->as<Insert>()->index());
+            put(" <- ");
+            return ref(def->as<Insert>()->value());
+        case Def::Tag::Intersection:
+            qualifier(def);
+            put('(');
+            list(def->ops(), " ∩ ");
+            return put(')');
+        case Def::Tag::KindArity:
+        case Def::Tag::KindMulti:
+        case Def::Tag::KindStar:
+            put(def->name().view());
+            if (auto q = get_qualifier(def->op(0)); q && *q == Qualifier::u)
+                return;
+            return stream(def->op(0));
+        case Def::Tag::Lit: {
+            qualifier(def);
+            if (!def->name().empty())
+                return put(def->name().view());
+            return put(def->as<Lit>()->box().get_u64());
+        }
+        case Def::Tag::Match:
+            put("match ");
+            ref(def->as<Match>()->destructee());
+            put(" with (");
+            list(def->as<Match>()->handlers(), ", ");
+            return put(')');
+        case Def::Tag::Param:
+            put("param ");
+            return ref(def->as<Param>()->lambda());
+        case Def::Tag::Lambda: {
+            auto lambda = def->as<Lambda>();
+            unique_name(lambda);
+            if (is_bot(lambda->codomain())) {
+                put(" := cn ");
+                ref(lambda->domain());
+            } else {
+                put(" := λ");
+                ref(lambda->domain());
+                put(" -> ");
+                ref(lambda->codomain());
+            }
+            put(" { ");
+            stream(lambda->body());
+            return put(" }");
+        }
+        case Def::Tag::Pack:
+            put("‹");
+            if (auto variadic = def->type()->isa<Variadic>())
+                stream(variadic->op(0));
+            else {
+                put(u64(def->type()->num_ops()));
+                put("ₐ");
+            }
+            put("; ");
+            ref(def->as<Pack>()->body());
+            return put("›");
+        case Def::Tag::Pi: {
+            auto pi = def->as<Pi>();
+            if (is_bot(pi->codomain())) {
+                put("Cn ");
+                return ref(pi->domain());
+            }
+            put("Π");
+            ref(pi->domain());
+            put(" -> ");
+            return ref(pi->codomain());
+        }
+        case Def::Tag::Pick:
+            put("pick:");
+            ref(def->type());
+            put('(');
+            ref(def->as<Pick>()->destructee());
+            return put(')');
+        case Def::Tag::Sigma:
+            qualifier(def);
+            put('[');
+            list(def->ops(), ", ");
+            return put(']');
+        case Def::Tag::Singleton:
+            put("S(");
+            list(def->ops(), ", ");
+            return put(')');
+        case Def::Tag::Universe:
+            return put(def->name().view());
+        case Def::Tag::Unknown:
+            put("<?_");
+            put(u64(def->gid()));
+            return put('>');
+        case Def::Tag::Tuple:
+            put('(');
+            list(def->ops(), ", ");
+            return put(')');
+        case Def::Tag::Var:
+            put("\\\\");
+            put(def->as<Var>()->index());
+            put("::");
+            return ref(def->type());
+        case Def::Tag::Variadic:
+            put("«");
+            ref(def->as<Variadic>()->arity());
+            put("; ");
+            ref(def->as<Variadic>()->body());
+            return put("»");
+        case Def::Tag::Variant:
+            qualifier(def);
+            put('(');
+            list(def->ops(), " ∪ ");
+            return put(')');
+        default: THORIN_UNREACHABLE;
+    }
 }
 
-DefPrinter& Kind::stream(DefPrinter& p) const {
-    p << name();
-    if (auto q = get_qualifier(op(0)))
-        if (q == Qualifier::u)
-            return p;
-    return p << op(0);
+void DefWriter::enqueue(const Def* def) {
+    if (auto lambda = def->isa<Lambda>()) {
+        if (follow_lambdas_)
+            lambdas_.emplace_back(lambda);
+    } else {
+        stack_.emplace_back(def);
+    }
+    done_.emplace(def);
 }
 
-DefPrinter& Lit::stream(DefPrinter& p) const {
-    qualifier_stream(p);
-    if (!name().empty())
-        return p << name();
-    return p << std::to_string(box().get_u64());
+bool DefWriter::push(const Def* def) {
+    if (def != nullptr && descend(def) && done_.emplace(def).second) {
+        enqueue(def);
+        return true;
+    }
+    return false;
 }
 
-DefPrinter& Match::stream(DefPrinter& p) const {
-    return streamf(p,"match {} with ({, })", p.str(destructee()), p.list(handlers()));
-}
+DefWriter& DefWriter::recurse(const Lambda* lambda) {
+    enqueue(lambda);
 
-DefPrinter& Param::stream(DefPrinter& p) const {
-    return streamf(p, "param {}", p.str(lambda()));
-}
+    while (next_lambda_ != lambdas_.size()) {
+        auto lambda = lambdas_[next_lambda_++];
 
-DefPrinter& Lambda::stream(DefPrinter& p) const {
-    if (is_bot(codomain()))
-        return streamf(p, "{} := cn {} {{ {} }}", unique_name(), p.str(domain()), body());
-    return streamf(p, "{} := λ{} -> {} {{ {} }}", unique_name(), p.str(domain()), p.str(codomain()), body());
-#if 0
-    streamf("λ{} -> {}", domain(), codomain());
-    p.indent().endl();
-    streamf("{}");
-    domain()->name_stream(p << "λ");
-    return body()->name_stream(p << ".");
-#endif
-}
-
-DefPrinter& Pack::stream(DefPrinter& p) const {
-    p << "‹";
-    if (auto var = type()->isa<Variadic>())
-        p << var->op(0);
-    else {
-        assert(type()->isa<Sigma>());
-        p << type()->num_ops() << "ₐ";
+        unique_name(lambda);
+        if (is_bot(lambda->codomain())) {
+            put(" := cn ");
+            ref(lambda->domain());
+        } else {
+            put(" := λ");
+            ref(lambda->domain());
+            put(" -> ");
+            ref(lambda->codomain());
+        }
+        put(" {");
+        ++level_;
+
+        if (lambda->body() != nullptr)
+            recurse(lambda->body());
+        --level_;
+        endl();
+        put('}');
+        endl();
+        endl();
     }
-    return streamf(p, "; {}›", p.str(body()));
-}
 
-DefPrinter& Pi::stream(DefPrinter& p) const {
-#if 0
-    qualifier_stream(p);
-    p  << "Π";
-    domain()->name_stream(p);
-    return codomain()->name_stream(p << ".");
-#endif
-    if (is_bot(codomain()))
-        return streamf(p, "Cn {}", p.str(domain()));
-    return streamf(p, "Π{} -> {}", p.str(domain()), p.str(codomain()));
+    lambdas_.clear();
+    next_lambda_ = 0;
+    return *this;
 }
 
-DefPrinter& Pick::stream(DefPrinter& p) const {
-#if 0
-    p << "pick:";
-    type()->name_stream(p);
-    destructee()->name_stream(p << "(");
-    return p << ")";
-#endif
-    return p << "TODO";
-}
+DefWriter& DefWriter::recurse(const Def* def) {
+    if (auto lambda = def->isa<Lambda>())
+        return recurse(lambda);
 
-DefPrinter& Sigma::stream(DefPrinter& p) const {
-    return streamf(qualifier_stream(p), "[{, }]", p.list((ops())));
-}
+    enqueue(def);
 
-DefPrinter& Singleton::stream(DefPrinter& p) const {
-    return streamf(p, "S({, })", p.list(ops()));
+    while (!stack_.empty()) {
+        auto def = stack_.back();
+
+        bool todo = false;
+        if (auto app = def->isa<App>()) {
+            todo |= push(app->callee());
+
+            if (app->arg()->isa<Tuple>() || app->arg()->isa<Pack>()) {
+                for (auto op : app->arg()->ops())
+                    todo |= push(op);
+            } else {
+                todo |= push(app->arg());
+            }
+        } else {
+            for (auto op : def->ops())
+                todo |= push(op);
+        }
+
+        if (!todo) {
+            endl();
+            unique_name(def);
+            put(": ");
+            stream(def->type());
+            put(" = ");
+            stream(def);
+            put(';');
+            stack_.pop_back();
+        }
+    }
+
+    return *this;
 }
 
-DefPrinter& Universe::stream(DefPrinter& p) const {
-    return p << name();
+DefWriter& DefWriter::recurse_alone(const Lambda* lambda) {
+    done_.clear();
+    follow_lambdas_ = false;
+    lambdas_.emplace_back(lambda);
+    recurse(lambda);
+    follow_lambdas_ = true;
+    return *this;
 }
 
-DefPrinter& Unknown::stream(DefPrinter& p) const {
-    return streamf(p, "<?_{}>", gid());
+void print_lambdas(ArrayRef<const Lambda*> lambdas, std::ostream& os, size_t num_threads) {
+    if (num_threads <= 1) {
+        DefWriter writer(&os);
+        for (auto lambda : lambdas)
+            writer.recurse_alone(lambda);
+        return;
+    }
+
+    // print in rounds to bound the size of the buffers
+    constexpr size_t batch = 256;
+    std::vector<std::unique_ptr<DefWriter>> writers;
+    for (size_t i = 0; i != num_threads; ++i)
+        writers.emplace_back(std::make_unique<DefWriter>(nullptr));
+
+    for (size_t begin = 0, e = lambdas.size(); begin < e; begin += num_threads * batch) {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t != num_threads; ++t) {
+            auto first = std::min(e, begin + t * batch);
+            auto last  = std::min(e, first + batch);
+            threads.emplace_back([&writers, lambdas, t, first, last] {
+                for (size_t i = first; i != last; ++i)
+                    writers[t]->recurse_alone(lambdas[i]);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        for (auto& writer : writers) {
+            os.write(writer->buffer().data(), writer->buffer().size());
+            writer->buffer().clear();
+        }
+    }
 }
 
-DefPrinter& Tuple::stream(DefPrinter& p) const {
-    return streamf(p, "({, })", p.list(ops()));
+//------------------------------------------------------------------------------
+
+DefPrinter& Def::stream(DefPrinter& p) const {
+    DefWriter writer(nullptr, p.tab());
+    writer.stream(this);
+    return p << writer.buffer();
 }
 
-DefPrinter& Var::stream(DefPrinter& p) const {
-#if 0
-    p << "\\\\" << index() << "::";
-    return type()->name_stream(p);
-#endif
-    return streamf(p, "\\\\{}::{}", index(), p.str(type()));
+DefPrinter& Def::stream_assign(DefPrinter& p) const {
+    return stream(streamf(p, "{}: {} = ", unique_name(), type()));
 }
 
-DefPrinter& Variadic::stream(DefPrinter& p) const {
-    return streamf(p, "«{}; {}»", p.str(arity()), p.str(body()));
+void Def::dump_assign() const {
+    DefPrinter printer;
+    stream_assign(printer).endl();
 }
 
-DefPrinter& Variant::stream(DefPrinter& p) const {
-    return streamf(qualifier_stream(p), "({ ∪ })", p.list(ops()));
+void Def::dump_rec() const {
+    DefPrinter p;
+    p.recurse(this).endl();
 }
 
 }
@@ -2,10 +2,13 @@
 #define THORIN_PRINT_H
 
 #include <functional>
+#include <string_view>
+#include <vector>
 
 #include "thorin/util/array.h"
 #include "thorin/util/hash.h"
 #include "thorin/util/stream.h"
+#include "thorin/util/types.h"
 
 namespace thorin {
 
@@ -35,6 +38,64 @@ private:
     DefSet done_;
 };
 
+/**
+ * Prints the same as @p DefPrinter::recurse but in a single pass without any temporary strings:
+ * each kind of @p Def is printed via a dedicated code path instead of interpreting a format string at runtime, and
+ * all output goes into one buffer which is flushed to the @c std::ostream in large chunks.
+ * @p Def::stream and @p DefPrinter::str print via @p stream and @p ref, so this is the only place which knows how to print a @p Def.
+ */
+class DefWriter {
+public:
+    DefWriter(const DefWriter&) = delete;
+    DefWriter& operator=(DefWriter) = delete;
+
+    /// Without @p ostream, all output stays in @p buffer.
+    explicit DefWriter(std::ostream* ostream = &std::cout, const char* tab = "    ")
+        : ostream_(ostream)
+        , tab_(tab)
+    {}
+    ~DefWriter() { flush(); }
+
+    DefWriter& recurse(const Def*);
+    DefWriter& recurse(const Lambda*);
+    /// Like @p recurse but other @p Lambda%s are only referred to by name; forgets which @p Def%s have already been printed.
+    DefWriter& recurse_alone(const Lambda*);
+    void stream(const Def*);    ///< Prints @p Def itself; its operands are referred to via @p ref.
+    void ref(const Def*);       ///< Prints the unique name of a @p Def with operands, or the @p Def itself otherwise.
+    std::string& buffer() { return buffer_; }
+    void flush();
+
+private:
+    static constexpr size_t FlushSize = 64 * 1024;
+
+    void put(std::string_view s) { buffer_.append(s); }
+    void put(char c) { buffer_.push_back(c); }
+    void put(u64);
+    void endl();
+    void unique_name(const Def*);
+    void qualifier(const Def*);
+    void list(Defs, std::string_view sep);
+    void enqueue(const Def*);
+    bool push(const Def*);
+
+    std::ostream* ostream_;
+    const char* tab_;
+    int level_ = 0;
+    bool follow_lambdas_ = true;
+    std::string buffer_;
+    std::vector<const Def*> stack_;
+    std::vector<const Lambda*> lambdas_;
+    size_t next_lambda_ = 0;
+    DefSet done_;
+};
+
+/**
+ * Prints each of @p lambdas via @p DefWriter::recurse_alone into @p os in order.
+ * With @p num_threads > 1, batches of @p lambdas are printed concurrently into separate buffers which are then concatenated.
+ * Unlike @p DefWriter::recurse, a @p Def used by several of @p lambdas is printed once for each of them.
+ */
+void print_lambdas(ArrayRef<const Lambda*> lambdas, std::ostream& os, size_t num_threads = 1);
+
 template void Streamable<DefPrinter>::dump() const;
 
 }
@@ -0,0 +1,527 @@
+#include "thorin/serialize.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "thorin/util/mmap.h"
+
+namespace thorin {
+
+/*
+ * Layout:
+ * - magic and version
+ * - symbols:    size and characters of each symbol
+ * - defs:       one record per node in topological order - see Writer::write(const Def*)
+ * - back-edges: operands of each nominal
+ * - index:      little-endian u32 tables - offsets of all symbols and nodes, (node, back-edge offset) pairs of all nominals,
+ *               externals and axioms sorted by name
+ * - trailer:    little-endian u32 sizes of these tables and the offset of the index
+ */
+
+static const char magic[] = {'T', 'H', 'O', 'R', 'I', 'N', 'B', 'C'};
+static constexpr u64 version = 2;
+
+enum Flags : u64 {
+    Nominal = 1 << 0,
+    CnEnd   = 1 << 1,
+    HasLoc  = 1 << 2,
+};
+
+enum Trailer { NumSymbols, NumDefs, NumNominals, NumExternals, NumAxioms, IndexOffset, TrailerSize };
+
+//------------------------------------------------------------------------------
+
+class Writer {
+public:
+    Writer(const World& world)
+        : world_(world)
+    {}
+
+    void run(std::ostream&);
+
+private:
+    void write(u64 val) {
+        do {
+            u8 byte = val & 0x7f;
+            val >>= 7;
+            buffer_.push_back(char(val != 0 ? byte | 0x80 : byte));
+        } while (val != 0);
+    }
+    void write_u32(size_t val) {
+        if (val > std::numeric_limits<u32>::max()) throw std::runtime_error("cannot serialize more than 4GB");
+        for (int i = 0; i != 4; ++i)
+            buffer_.push_back(char(val >> (8 * i)));
+    }
+    void write(Symbol);
+    void write_ref(const Def* def) { write(def == nullptr ? 0 : def2index_.find(def)->second + 1); }
+    void enqueue(const Def*);
+    void write(const Def*);
+    /// The operands of @p World::cn_end and of @p Axiom%s are not written - they are provided by the loading @p World.
+    bool has_back_edges(const Def* def) const { return def->is_nominal() && def != world_.cn_end() && !def->isa<Axiom>(); }
+
+    const World& world_;
+    std::string buffer_;
+    SymbolMap<u64> sym2index_;
+    std::vector<Symbol> symbols_;
+    GIDMap<const Def*, u64> def2index_;
+    std::vector<const Def*> defs_;
+};
+
+void Writer::write(Symbol sym) {
+    if (sym.empty()) return write(0_u64);
+    auto [i, success] = sym2index_.emplace(sym, symbols_.size() + 1);
+    if (success) symbols_.emplace_back(sym);
+    write(i->second);
+}
+
+/// Assigns indices in post-order: a nominal depends on its type, a structural @p Def additionally on its operands.
+void Writer::enqueue(const Def* root) {
+    if (root == nullptr || def2index_.contains(root)) return;
+
+    enum : u64 { OnStack = u64(-1) };
+    auto deps = [](const Def* def, size_t i) -> const Def* {
+        if (i == 0) return def->isa<Universe>() ? nullptr : def->type();
+        if (def->is_nominal()) return nullptr;
+        return def->op(i - 1);
+    };
+    auto num_deps = [](const Def* def) { return def->is_nominal() ? 1 : def->num_ops() + 1; };
+
+    std::vector<std::pair<const Def*, size_t>> stack;
+    def2index_[root] = OnStack;
+    stack.emplace_back(root, 0);
+
+    while (!stack.empty()) {
+        auto& [def, i] = stack.back();
+        if (i != num_deps(def)) {
+            auto dep = deps(def, i++);
+            if (dep == nullptr) continue;
+            auto [j, success] = def2index_.emplace(dep, OnStack);
+            if (success)
+                stack.emplace_back(dep, 0);
+            else if (j->second == OnStack)
+                throw std::runtime_error("cannot serialize nominal whose type depends on itself");
+        } else {
+            def2index_[def] = defs_.size();
+            defs_.emplace_back(def);
+            stack.pop_back();
+        }
+    }
+}
+
+void Writer::write(const Def* def) {
+    auto tag = def->tag();
+    u64 flags = 0;
+    if (def->is_nominal())      flags |= Nominal;
+    if (def == world_.cn_end()) flags |= CnEnd;
+    if (def->loc().is_set())  flags |= HasLoc;
+
+    write(u64(tag));
+    write(flags);
+    write_ref(def->isa<Universe>() ? nullptr : def->type());
+    write(def->num_ops());
+    if (!def->is_nominal()) {
+        for (auto op : def->ops())
+            write_ref(op);
+    }
+
+    if (auto lit = def->isa<Lit>())
+        write(lit->box().get_u64());
+    else if (auto var = def->isa<Var>())
+        write(var->index());
+
+    write(def->name());
+    if (flags & HasLoc) {
+        auto loc = def->loc();
+        write(Symbol(loc.filename()));
+        write(loc.front_line());
+        write(loc.front_col());
+        write(loc.back_line());
+        write(loc.back_col());
+    }
+}
+
+void Writer::run(std::ostream& os) {
+    std::vector<const Def*> externals;
+    for (auto [name, def] : world_.externals())
+        externals.emplace_back(def);
+    std::sort(externals.begin(), externals.end(), DefLt());
+
+    // nominals are emitted before their operands are traversed - hence, keep traversing until all operands are known
+    for (auto external : externals)
+        enqueue(external);
+    for (size_t i = 0; i != defs_.size(); ++i) {
+        if (has_back_edges(defs_[i])) {
+            for (auto op : defs_[i]->ops())
+                enqueue(op);
+        }
+    }
+
+    std::vector<size_t> def_offsets;
+    for (auto def : defs_) {
+        def_offsets.emplace_back(buffer_.size());
+        write(def);
+    }
+
+    std::vector<std::pair<size_t, size_t>> nominals;
+    for (size_t i = 0, e = defs_.size(); i != e; ++i) {
+        if (has_back_edges(defs_[i])) {
+            nominals.emplace_back(i, buffer_.size());
+            for (auto op : defs_[i]->ops())
+                write_ref(op);
+        }
+    }
+
+    // the symbol table goes first but is only known by now
+    auto body = std::move(buffer_);
+    buffer_.assign(magic, sizeof(magic));
+    write(version);
+    std::vector<size_t> sym_offsets;
+    for (auto sym : symbols_) {
+        sym_offsets.emplace_back(buffer_.size());
+        write(sym.size());
+        buffer_.append(sym.view());
+    }
+    auto base = buffer_.size();
+    buffer_.append(body);
+
+    auto by_name = [](const Def* a, const Def* b) { return a->name().view() < b->name().view(); };
+    std::vector<const Def*> axioms;
+    for (auto def : defs_) {
+        if (def->isa<Axiom>()) axioms.emplace_back(def);
+    }
+    std::sort(externals.begin(), externals.end(), by_name);
+    std::sort(axioms.begin(), axioms.end(), by_name);
+
+    auto index = buffer_.size();
+    for (auto offset : sym_offsets) write_u32(offset);
+    for (auto offset : def_offsets) write_u32(base + offset);
+    for (auto [i, offset] : nominals) {
+        write_u32(i);
+        write_u32(base + offset);
+    }
+    for (auto external : externals) write_u32(def2index_[external]);
+    for (auto axiom : axioms)       write_u32(def2index_[axiom]);
+
+    write_u32(symbols_.size());
+    write_u32(defs_.size());
+    write_u32(nominals.size());
+    write_u32(externals.size());
+    write_u32(axioms.size());
+    write_u32(index);
+
+    os.write(buffer_.data(), buffer_.size());
+}
+
+//------------------------------------------------------------------------------
+
+class Snapshot::Decoder {
+public:
+    Decoder(const Snapshot& snapshot, size_t offset)
+        : snapshot_(snapshot)
+        , cur_(snapshot.buffer_.data() + std::min(offset, snapshot.buffer_.size()))
+        , end_(snapshot.buffer_.data() + snapshot.buffer_.size())
+    {}
+
+    u64 read() {
+        u64 val = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cur_ == end_) snapshot_.error("unexpected end of input");
+            u8 byte = *cur_++;
+            val |= u64(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return val;
+        }
+        snapshot_.error("malformed number");
+    }
+    std::string_view read_bytes(u64 size) {
+        if (size > u64(end_ - cur_)) snapshot_.error("unexpected end of input");
+        std::string_view result(cur_, size);
+        cur_ += size;
+        return result;
+    }
+
+private:
+    const Snapshot& snapshot_;
+    const char* cur_;
+    const char* end_;
+};
+
+Snapshot::Snapshot(World& world, std::string_view buffer, bool check)
+    : buffer_(buffer)
+    , world_(world)
+    , check_(check)
+{
+    open();
+}
+
+Snapshot::Snapshot(World& world, const char* filename, bool check)
+    : file_(std::make_unique<MappedFile>(filename))
+    , buffer_(file_->view())
+    , world_(world)
+    , check_(check)
+{
+    open();
+}
+
+Snapshot::~Snapshot() {}
+
+void Snapshot::error(const char* msg) const { throw std::runtime_error(std::string("deserialize: ") + msg); }
+
+u32 Snapshot::read_u32(size_t offset) const {
+    if (offset > buffer_.size() || buffer_.size() - offset < 4) error("invalid offset");
+    auto p = reinterpret_cast<const u8*>(buffer_.data() + offset);
+    return u32(p[0]) | u32(p[1]) << 8_u32 | u32(p[2]) << 16_u32 | u32(p[3]) << 24_u32;
+}
+
+void Snapshot::open() {
+    if (buffer_.size() < sizeof(magic) + TrailerSize * 4 || !std::equal(magic, magic + sizeof(magic), buffer_.data()))
+        error("not a thorin binary");
+    if (Decoder(*this, sizeof(magic)).read() != version) error("unsupported version");
+
+    auto trailer = buffer_.size() - TrailerSize * 4;
+    auto get = [&](Trailer t) -> size_t { return read_u32(trailer + t * 4); };
+    size_t num_symbols = get(NumSymbols), num_defs = get(NumDefs);
+    num_nominals_  = get(NumNominals);
+    num_externals_ = get(NumExternals);
+    num_axioms_    = get(NumAxioms);
+
+    symbol_table_   = get(IndexOffset);
+    def_table_      = symbol_table_   + 4 * num_symbols;
+    nominal_table_  = def_table_      + 4 * num_defs;
+    external_table_ = nominal_table_  + 8 * num_nominals_;
+    axiom_table_    = external_table_ + 4 * num_externals_;
+    if (axiom_table_ + 4 * num_axioms_ != trailer) error("corrupt index");
+
+    symbols_.resize(num_symbols);
+    defs_.resize(num_defs);
+}
+
+std::string_view Snapshot::symbol_view(u64 i) const {
+    if (i == 0) return {};
+    if (i > symbols_.size()) error("invalid symbol index");
+    Decoder decoder(*this, read_u32(symbol_table_ + 4 * (i - 1)));
+    return decoder.read_bytes(decoder.read());
+}
+
+Symbol Snapshot::symbol(u64 i) {
+    if (i == 0) return {};
+    if (i > symbols_.size()) error("invalid symbol index");
+    auto& sym = symbols_[i - 1];
+    if (sym.empty()) sym = symbol_view(i); // only the empty symbol is empty and it is never stored
+    return sym;
+}
+
+std::string_view Snapshot::name(size_t i) const {
+    if (i >= defs_.size()) error("invalid def index");
+    Decoder decoder(*this, read_u32(def_table_ + 4 * i));
+    auto tag = Def::Tag(decoder.read());
+    auto flags = decoder.read();
+    decoder.read(); // type
+    auto num_ops = decoder.read();
+    if (!(flags & Nominal)) {
+        for (u64 j = 0; j != num_ops; ++j)
+            decoder.read();
+    }
+    if (tag == Def::Tag::Lit || tag == Def::Tag::Var)
+        decoder.read();
+    return symbol_view(decoder.read());
+}
+
+size_t Snapshot::find_by_name(size_t table, size_t num, std::string_view name) const {
+    size_t lo = 0, hi = num;
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        auto i = read_u32(table + 4 * mid);
+        auto cmp = this->name(i).compare(name);
+        if (cmp == 0) return i;
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return size_t(-1);
+}
+
+void Snapshot::make_external(const Def* def) {
+    if (auto old = world_.lookup_external(def->name()); old != nullptr && old != def)
+        error("external already present");
+    world_.make_external(def);
+}
+
+const Def* Snapshot::lookup_external(std::string_view name) {
+    auto i = find_by_name(external_table_, num_externals_, name);
+    if (i == size_t(-1)) return nullptr;
+    auto external = expand(def(i));
+    make_external(external);
+    return external;
+}
+
+const Axiom* Snapshot::lookup_axiom(std::string_view name) {
+    auto i = find_by_name(axiom_table_, num_axioms_, name);
+    if (i == size_t(-1)) return nullptr;
+    auto axiom = def(i)->isa<Axiom>();
+    if (axiom == nullptr) error("invalid axiom");
+    return axiom;
+}
+
+/// Materializes all dependencies of a node in post-order via an explicit stack - a node may only depend on nodes with smaller indices.
+const Def* Snapshot::def(size_t i) {
+    if (i >= defs_.size()) error("invalid def index");
+    if (defs_[i] != nullptr) return defs_[i];
+
+    stack_.emplace_back(i);
+    while (!stack_.empty()) {
+        auto j = stack_.back();
+        if (defs_[j] != nullptr) {
+            stack_.pop_back();
+            continue;
+        }
+
+        bool ready = true;
+        auto dep = [&](u64 ref) -> const Def* {
+            if (ref == 0) return nullptr;
+            if (ref - 1 >= j) error("invalid def index");
+            if (auto def = defs_[ref - 1]) return def;
+            stack_.emplace_back(ref - 1);
+            ready = false;
+            return nullptr;
+        };
+
+        Decoder decoder(*this, read_u32(def_table_ + 4 * j));
+        auto raw_tag = decoder.read();
+        if (raw_tag >= u64(Def::Tag::Num)) error("invalid tag");
+        auto flags = decoder.read();
+        auto type = dep(decoder.read());
+        auto num_ops = decoder.read();
+        if (num_ops > buffer_.size()) error("invalid number of operands");
+
+        ops_.clear();
+        if (!(flags & Nominal)) {
+            for (u64 k = 0; k != num_ops; ++k) {
+                auto ref = decoder.read();
+                if (ref == 0) error("structural def with missing operand");
+                ops_.emplace_back(dep(ref));
+            }
+        }
+
+        if (ready) {
+            defs_[j] = build(decoder, j, Def::Tag(raw_tag), flags, type, num_ops);
+            ++num_materialized_;
+            stack_.pop_back();
+        }
+    }
+
+    return defs_[i];
+}
+
+const Def* Snapshot::build(Decoder& decoder, size_t i, Def::Tag tag, u64 flags, const Def* type, u64 num_ops) {
+    Box box;
+    if (tag == Def::Tag::Lit || tag == Def::Tag::Var)
+        box = Box(decoder.read());
+
+    Debug dbg(symbol(decoder.read()));
+    if (flags & HasLoc) {
+        auto filename = symbol(decoder.read());
+        auto front_line = decoder.read(), front_col = decoder.read(), back_line = decoder.read(), back_col = decoder.read();
+        dbg.set(Loc(filename.c_str(), front_line, front_col, back_line, back_col));
+    }
+
+    if (flags & CnEnd) return world_.cn_end();
+    if (tag == Def::Tag::Universe) return world_.universe();
+    if (type == nullptr) error("missing type");
+
+    if (flags & Nominal) {
+        Def* nominal = nullptr;
+        switch (tag) {
+            case Def::Tag::Axiom:
+                if (auto axiom = world_.lookup_axiom(dbg.name())) return axiom;
+                return world_.axiom(type, dbg);
+            case Def::Tag::Lambda:
+                if (!type->isa<Pi>() || num_ops != 2) error("invalid nominal lambda");
+                nominal = world_.lambda(type->as<Pi>(), dbg);
+                break;
+            case Def::Tag::Sigma:        nominal = world_.sigma(type, num_ops, dbg); break;
+            case Def::Tag::Variant:      nominal = world_.variant(type, num_ops, dbg); break;
+            case Def::Tag::Intersection: nominal = world_.intersection(type, num_ops, dbg); break;
+            case Def::Tag::Unknown:      nominal = world_.unknown(dbg); break;
+            default: error("unsupported nominal");
+        }
+        stubs_.emplace(nominal, i);
+        return nominal;
+    }
+
+    Defs ops(ops_);
+    switch (tag) {
+        case Def::Tag::KindArity:
+        case Def::Tag::KindMulti:
+        case Def::Tag::KindStar:
+        case Def::Tag::Pack:
+        case Def::Tag::Pick:
+        case Def::Tag::Singleton:    if (ops.size() != 1) error("invalid number of operands"); break;
+        case Def::Tag::App:
+        case Def::Tag::Pi:
+        case Def::Tag::Extract:
+        case Def::Tag::Variadic:     if (ops.size() != 2) error("invalid number of operands"); break;
+        case Def::Tag::Lambda:       if (ops.size() != 2 || !type->isa<Pi>()) error("invalid lambda"); break;
+        case Def::Tag::Param:        if (ops.size() != 1 || !ops[0]->isa<Lambda>()) error("invalid param"); break;
+        case Def::Tag::Insert:       if (ops.size() != 3) error("invalid number of operands"); break;
+        case Def::Tag::Match:        if (ops.empty()) error("invalid number of operands"); break;
+        case Def::Tag::Axiom:
+        case Def::Tag::Unknown:      error("unsupported structural def");
+        default: break;
+    }
+
+    if (!check_) return world_.raw_rebuild(tag, type, ops, box, dbg);
+
+    auto def = world_.rebuild(tag, type, ops, box, dbg);
+    if (def->type() != type) error("type mismatch");
+    return def;
+}
+
+const Def* Snapshot::expand(const Def* nominal) {
+    auto i = stubs_.find(nominal);
+    if (i == stubs_.end()) return nominal;
+    auto index = i->second;
+    stubs_.erase(i);
+
+    size_t lo = 0, hi = num_nominals_;
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        if (read_u32(nominal_table_ + 8 * mid) < index)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == num_nominals_ || read_u32(nominal_table_ + 8 * lo) != index) error("missing back-edges");
+
+    Decoder decoder(*this, read_u32(nominal_table_ + 8 * lo + 4));
+    auto stub = const_cast<Def*>(nominal);
+    for (size_t j = 0, e = stub->num_ops(); j != e; ++j) {
+        if (auto ref = decoder.read())
+            stub->set(j, def(ref - 1));
+    }
+    return nominal;
+}
+
+void Snapshot::materialize() {
+    for (size_t i = 0, e = defs_.size(); i != e; ++i)
+        def(i);
+    for (size_t i = 0; i != num_nominals_; ++i)
+        expand(def(read_u32(nominal_table_ + 8 * i)));
+    for (size_t i = 0; i != num_externals_; ++i)
+        make_external(def(read_u32(external_table_ + 4 * i)));
+}
+
+//------------------------------------------------------------------------------
+
+void serialize(const World& world, std::ostream& os) { Writer(world).run(os); }
+
+void serialize_file(const World& world, const char* filename) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) throw std::runtime_error(std::string("cannot open file '") + filename + "'");
+    serialize(world, ofs);
+}
+
+void deserialize(World& world, std::string_view buffer, bool check) { Snapshot(world, buffer, check).materialize(); }
+void deserialize_file(World& world, const char* filename, bool check) { Snapshot(world, filename, check).materialize(); }
+
+}
@@ -0,0 +1,108 @@
+#ifndef THORIN_SERIALIZE_H
+#define THORIN_SERIALIZE_H
+
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+#include "thorin/world.h"
+
+namespace thorin {
+
+class MappedFile;
+
+/**
+ * Writes all @p Def%s reachable from the externals of @p world in a compact binary format:
+ * a symbol table followed by a topologically ordered node table - each node holds its tag, the indices of its type and operands, its payload and its @p Debug info.
+ * The operands of nominals are written in a separate section afterwards such that nominals may be recursive.
+ * All numbers are LEB128-encoded.
+ * A trailing index of fixed-width offsets allows a @p Snapshot to access any node without reading the ones before.
+ */
+void serialize(const World& world, std::ostream& os);
+void serialize_file(const World& world, const char* filename);
+
+/**
+ * Loads the @p Def%s written by @p serialize into @p world and makes the externals external again.
+ * @p Axiom%s are identified by name: they are mapped to their counterparts in @p world if present.
+ * If @p check is set, all structural @p Def%s are rebuilt via the regular factory methods of the @p World - this normalizes and checks them.
+ * Otherwise, they are hash-consed exactly as written; only use this mode for files written by @p serialize itself.
+ * Throws @c std::runtime_error if @p buffer is malformed.
+ */
+void deserialize(World& world, std::string_view buffer, bool check = false);
+void deserialize_file(World& world, const char* filename, bool check = false); ///< Memory-maps @p filename.
+
+/**
+ * A read-only view of a file written by @p serialize that materializes its @p Def%s into a @p World on first access.
+ * Materializing a @p Def also materializes its type and its operands - unless it is a nominal:
+ * a nominal stays a stub without operands until it is @p expand%ed.
+ * Hence, looking up a few externals only materializes what these externals immediately consist of.
+ * Besides the mapped file itself, a @p Snapshot only occupies one pointer per node and symbol.
+ * Throws @c std::runtime_error if the file is malformed.
+ */
+class Snapshot {
+public:
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(Snapshot) = delete;
+
+    /// Opens @p buffer which must outlive this @p Snapshot.
+    Snapshot(World& world, std::string_view buffer, bool check = false);
+    /// Memory-maps @p filename.
+    Snapshot(World& world, const char* filename, bool check = false);
+    ~Snapshot();
+
+    World& world() { return world_; }
+    size_t num_defs() const { return defs_.size(); }
+    size_t num_externals() const { return num_externals_; }
+    size_t num_materialized() const { return num_materialized_; }
+
+    //@{ lookup - materializes the result
+    /// Expands the external @p name and makes it external in @p world; returns @c nullptr if there is no such external.
+    const Def* lookup_external(std::string_view name);
+    const Axiom* lookup_axiom(std::string_view name);
+    //@}
+
+    //@{ materialization
+    const Def* def(size_t i); ///< Materializes the @p i-th node; nominals are not expanded.
+    bool is_expanded(const Def* nominal) const { return !stubs_.contains(nominal); }
+    /// Sets the operands of @p nominal if it is a stub of this @p Snapshot; these operands are materialized but not expanded.
+    const Def* expand(const Def* nominal);
+    /// Materializes and expands everything and makes all externals external.
+    void materialize();
+    //@}
+
+private:
+    class Decoder;
+
+    void open();
+    [[noreturn]] void error(const char* msg) const;
+    u32 read_u32(size_t offset) const;
+    std::string_view symbol_view(u64 i) const;
+    Symbol symbol(u64 i);
+    void make_external(const Def*);
+    std::string_view name(size_t i) const;
+    size_t find_by_name(size_t table, size_t num, std::string_view name) const;
+    const Def* build(Decoder&, size_t i, Def::Tag, u64 flags, const Def* type, u64 num_ops);
+
+    std::unique_ptr<MappedFile> file_;
+    std::string_view buffer_;
+    World& world_;
+    bool check_;
+    size_t num_externals_ = 0;
+    size_t num_nominals_ = 0;
+    size_t num_axioms_ = 0;
+    size_t symbol_table_ = 0;   ///< Offset of the symbol offsets.
+    size_t def_table_ = 0;      ///< Offset of the node offsets.
+    size_t nominal_table_ = 0;  ///< Offset of the (node, back-edge offset) pairs.
+    size_t external_table_ = 0; ///< Offset of the externals sorted by name.
+    size_t axiom_table_ = 0;    ///< Offset of the @p Axiom%s sorted by name.
+    size_t num_materialized_ = 0;
+    std::vector<Symbol> symbols_;
+    std::vector<const Def*> defs_;
+    DefMap<size_t> stubs_;
+    std::vector<size_t> stack_;
+    std::vector<const Def*> ops_; ///< Reused for all structural @p Def%s to avoid allocations.
+};
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include "thorin/stats.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "thorin/def.h"
+
+namespace thorin {
+
+static const char* tag2str(size_t tag) {
+    static const char* names[] = {
+        "Universe",
+        "KindArity", "KindMulti", "KindStar",
+        "App", "Lambda", "Param", "Pi",
+        "Extract", "Insert", "Tuple", "Pack", "Sigma", "Variadic",
+        "Match", "Variant",
+        "Pick", "Intersection",
+        "Lit", "Axiom",
+        "Bot", "Top",
+        "Singleton",
+        "Unknown",
+        "Var",
+    };
+    static_assert(std::size(names) == size_t(Def::Tag::Num), "names out of sync with Def::Tag");
+    return names[tag];
+}
+
+/// The @p normalizers sorted by name to get a deterministic output.
+static std::vector<std::pair<const Axiom*, Stats::Normalizer>> sorted(const GIDMap<const Axiom*, Stats::Normalizer>& normalizers) {
+    std::vector<std::pair<const Axiom*, Stats::Normalizer>> result(normalizers.begin(), normalizers.end());
+    std::sort(result.begin(), result.end(), [](auto& p1, auto& p2) { return p1.first->name().view() < p2.first->name().view(); });
+    return result;
+}
+
+static double average(size_t sum, size_t num) { return num == 0 ? 0.0 : double(sum) / double(num); }
+
+std::ostream& Stats::stream(std::ostream& os) const {
+    if (!enabled)
+        return os << "statistics disabled - build with THORIN_ENABLE_STATS" << std::endl;
+
+    os << std::left << std::setw(16) << "tag" << std::right
+       << std::setw(12) << "created" << std::setw(12) << "deduped" << std::setw(12) << "nominals" << std::endl;
+    for (size_t i = 0; i != nodes.size(); ++i) {
+        auto& n = nodes[i];
+        if (n.created == 0 && n.deduped == 0 && n.nominals == 0) continue;
+        os << std::left << std::setw(16) << tag2str(i) << std::right
+           << std::setw(12) << n.created << std::setw(12) << n.deduped << std::setw(12) << n.nominals << std::endl;
+    }
+
+    os << std::endl;
+    os << "defs:             " << num_defs << std::endl;
+    os << "rehashes:         " << rehashes << std::endl;
+    os << "probe length:     " << "avg " << average(probe_length_sum, num_defs) << ", max " << probe_length_max << std::endl;
+    os << "reclaims:         " << reclaims << " (" << reclaimed_bytes << " bytes)" << std::endl;
+    os << "reduce:           " << reduce_calls << " calls, " << reduce_rebuilt << " rebuilt" << std::endl;
+    os << "type check cache: " << type_check_hits << " hits, " << type_check_misses << " misses" << std::endl;
+    os << "zones:           ";
+    for (auto bytes : zone_bytes)
+        os << ' ' << bytes;
+    os << " bytes" << std::endl;
+
+    os << std::endl;
+    os << std::left << std::setw(16) << "normalizer" << std::right << std::setw(12) << "calls" << std::setw(12) << "hits" << std::endl;
+    for (auto& [axiom, n] : sorted(normalizers))
+        os << std::left << std::setw(16) << axiom->name().view() << std::right << std::setw(12) << n.calls << std::setw(12) << n.hits << std::endl;
+    return os;
+}
+
+static std::ostream& quote(std::ostream& os, std::string_view s) {
+    os << '"';
+    for (auto c : s) {
+        if (c == '"' || c == '\\') os << '\\';
+        os << c;
+    }
+    return os << '"';
+}
+
+std::ostream& Stats::json(std::ostream& os) const {
+    os << "{\"enabled\": " << (enabled ? "true" : "false");
+    if (!enabled)
+        return os << "}" << std::endl;
+
+    os << ", \"nodes\": {";
+    const char* sep = "";
+    for (size_t i = 0; i != nodes.size(); ++i) {
+        auto& n = nodes[i];
+        os << sep << '"' << tag2str(i) << "\": {\"created\": " << n.created << ", \"deduped\": " << n.deduped << ", \"nominals\": " << n.nominals << "}";
+        sep = ", ";
+    }
+    os << "}";
+    os << ", \"defs\": " << num_defs;
+    os << ", \"rehashes\": " << rehashes;
+    os << ", \"probe_length\": {\"sum\": " << probe_length_sum << ", \"max\": " << probe_length_max << "}";
+    os << ", \"reclaims\": {\"count\": " << reclaims << ", \"bytes\": " << reclaimed_bytes << "}";
+    os << ", \"reduce\": {\"calls\": " << reduce_calls << ", \"rebuilt\": " << reduce_rebuilt << "}";
+    os << ", \"type_check\": {\"hits\": " << type_check_hits << ", \"misses\": " << type_check_misses << "}";
+
+    os << ", \"zones\": [";
+    sep = "";
+    for (auto bytes : zone_bytes) {
+        os << sep << bytes;
+        sep = ", ";
+    }
+    os << "]";
+
+    os << ", \"normalizers\": {";
+    sep = "";
+    for (auto& [axiom, n] : sorted(normalizers)) {
+        quote(os << sep, axiom->name().view()) << ": {\"calls\": " << n.calls << ", \"hits\": " << n.hits << "}";
+        sep = ", ";
+    }
+    return os << "}}" << std::endl;
+}
+
+}
@@ -0,0 +1,61 @@
+#ifndef THORIN_STATS_H
+#define THORIN_STATS_H
+
+#include <array>
+#include <ostream>
+#include <vector>
+
+#include "thorin/def.h"
+
+/// Only keeps its arguments if thorin is built with @c THORIN_ENABLE_STATS - otherwise, the instrumentation costs nothing.
+#ifdef THORIN_ENABLE_STATS
+#define THORIN_STATS(...) __VA_ARGS__
+#else
+#define THORIN_STATS(...)
+#endif
+
+namespace thorin {
+
+/**
+ * Counters of the hot paths of a @p World.
+ * They are only collected if thorin is built with @c THORIN_ENABLE_STATS; see @p World::stats.
+ */
+struct Stats {
+#ifdef THORIN_ENABLE_STATS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    struct Nodes {
+        size_t created  = 0; ///< New structural @p Def%s hash-consed by @p World::unify.
+        size_t deduped  = 0; ///< Structural @p Def%s which already existed.
+        size_t nominals = 0; ///< Nominal @p Def%s inserted.
+    };
+
+    struct Normalizer {
+        size_t calls = 0;
+        size_t hits  = 0; ///< Calls which actually normalized.
+    };
+
+    std::array<Nodes, size_t(Def::Tag::Num)> nodes; ///< Per @p Def::Tag.
+    size_t reclaims = 0;                            ///< Deduped @p Def%s whose memory was given back to the current @p Zone.
+    size_t reclaimed_bytes = 0;
+    size_t rehashes = 0;                            ///< Of the @p World's @p DefSet.
+    size_t probe_length_sum = 0;                    ///< Of all elements in the @p DefSet at the time of @p World::stats.
+    size_t probe_length_max = 0;
+    size_t num_defs = 0;
+    GIDMap<const Axiom*, Normalizer> normalizers;
+    size_t reduce_calls = 0;                        ///< Of @p reduce and @p shift_free_vars that had to do something.
+    size_t reduce_rebuilt = 0;                      ///< @p Def%s rebuilt by these.
+    size_t type_check_hits = 0;                     ///< Def%s already checked in the same environment.
+    size_t type_check_misses = 0;
+    std::vector<size_t> zone_bytes{0};              ///< Bytes allocated per @p Zone.
+
+    std::ostream& stream(std::ostream&) const;      ///< Human-readable table.
+    std::ostream& json(std::ostream&) const;        ///< Machine-readable.
+};
+
+}
+
+#endif
@@ -1,43 +1,218 @@
 #include "thorin/transform/import.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
+/// Are all ops of the nominal @p def set?
+static bool is_defined(const Def* def) {
+    return !def->empty() && std::all_of(def->ops().begin(), def->ops().end(), [](auto op) { return op != nullptr; });
+}
+
+u64 Importer::fingerprint(const Def* nominal) {
+    auto hash = hash_begin(u64(nominal->num_ops()));
+    for (auto op : nominal->ops())
+        hash = hash_combine(hash, op == nullptr ? u32(-1) : op->gid());
+    return hash;
+}
+
 void Importer::check_todo(const Def* old_def, const Def* new_def) {
     if (old_def->num_ops() != new_def->num_ops())
         todo_ = true;
     else {
-        for (size_t i = 0, e = old_def->num_ops(); !todo_ && i != e; ++i)
-            todo_ |= old2new_[old_def->op(i)] == new_def->op(i);
+        for (size_t i = 0, e = old_def->num_ops(); !todo_ && i != e; ++i) {
+            if (auto op = old_def->op(i))
+                todo_ |= old2new_[op] != new_def->op(i);
+        }
     }
 }
 
+std::vector<const Def*> Importer::collect_nominals(const Def* nominal) const {
+    std::vector<const Def*> result;
+    std::vector<const Def*> stack;
+    DefSet done;
+    auto push = [&](const Def* def) {
+        if (def == nullptr || !done.emplace(def).second) return;
+        if (def->is_nominal())
+            result.emplace_back(def);
+        else
+            stack.emplace_back(def);
+    };
+
+    for (auto op : nominal->ops())
+        push(op);
+    while (!stack.empty()) {
+        auto def = pop(stack);
+        if (!def->isa<Universe>())
+            push(def->type());
+        for (auto op : def->ops())
+            push(op);
+    }
+    return result;
+}
+
+const std::vector<const Def*>& Importer::deps(const Def* old_def, Nominal& info) const {
+    if (!info.deps)
+        info.deps = collect_nominals(old_def);
+    return *info.deps;
+}
+
 const Def* Importer::import(Tracker old_def) {
+    THORIN_TRACE("Importer::import");
     if (auto new_def = find(old2new_, old_def)) {
         assert(&new_def->world() == &world_);
         assert(!new_def->is_replaced());
+        ++stats_.shared;
+        if (old_def->is_nominal()) {
+            checks_.emplace_back(old_def);
+            run();
+        }
         return new_def;
     }
 
-    auto new_type = import(old_def->type());
-    Def* new_nominal = nullptr;
-    if (old_def->is_nominal())
-        new_nominal = checked_emplace(old2new_, old_def.def(), old_def->stub(world(), new_type));
+    stack_.emplace_back(old_def);
+    run();
+    return old2new_[old_def];
+}
 
-    DefArray new_ops(old_def->num_ops());
-    for (size_t i = 0, e = old_def->num_ops(); i != e; ++i)
-        new_ops[i] = import(old_def->op(i));
+void Importer::run() {
+    while (true) {
+        if (!stack_.empty()) {
+            step(stack_.back());
+        } else if (!to_fill_.empty()) {
+            if (fill(to_fill_.back()))
+                to_fill_.pop_back();
+        } else if (!checks_.empty()) {
+            check(pop(checks_));
+        } else {
+            break;
+        }
+    }
+}
 
-    if (new_nominal != nullptr) {
-        for (size_t i = 0, e = new_ops.size(); i != e; ++i)
-            new_nominal->set(i, new_ops[i]);
-        check_todo(old_def, new_nominal);
-        return new_nominal;
+/// Imports @p old_def once its type and - if it is structural - its ops are imported; otherwise, pushes these first.
+void Importer::step(const Def* old_def) {
+    if (old2new_.contains(old_def)) {
+        stack_.pop_back();
+        if (old_def->is_nominal()) checks_.emplace_back(old_def);
+        return;
+    }
+
+    auto map = [&](const Def* new_def) {
+        stack_.pop_back();
+        checked_emplace(old2new_, old_def, new_def);
+    };
+
+    auto& src = old_def->world();
+    if (old_def->isa<Universe>()) {
+        ++stats_.shared;
+        return map(world().universe());
+    }
+    if (old_def == src.cn_end()) {
+        ++stats_.shared;
+        return map(world().cn_end());
+    }
+    auto new_type = find(old2new_, old_def->type());
+    if (new_type == nullptr) {
+        stack_.emplace_back(old_def->type());
+        return;
     }
 
+    if (old_def->isa<Axiom>()) {
+        if (auto new_axiom = world().lookup_axiom(old_def->name())) {
+            if (new_axiom->type() != new_type)
+                world().errorf("axiom '{}' of type '{}' clashes with existing axiom of type '{}'", old_def->name(), new_type, new_axiom->type());
+            ++stats_.shared;
+            return map(new_axiom);
+        }
+    }
+
+    if (old_def->is_nominal()) {
+        // merge externals by name
+        auto name = old_def->name();
+        auto external = src.lookup_external(name) == old_def ? world().lookup_external(name) : nullptr;
+        if (external != nullptr) {
+            if (external->type() != new_type)
+                world().errorf("external '{}' of type '{}' clashes with existing external of type '{}'", name, new_type, external->type());
+            if (is_defined(external) && is_defined(old_def))
+                world().errorf("redefinition of external '{}'", name);
+        }
+        ++(external ? stats_.shared : stats_.copied);
+        map(external ? external : old_def->stub(world(), new_type));
+        nominals_[old_def].round = round_;
+        to_fill_.emplace_back(old_def);
+        return;
+    }
+
+    bool ready = true;
+    for (auto op : old_def->ops()) {
+        if (!old2new_.contains(op)) {
+            stack_.emplace_back(op);
+            ready = false;
+        }
+    }
+    if (!ready) return;
+
+    DefArray new_ops(old_def->num_ops(), [&](size_t i) { return old2new_[old_def->op(i)]; });
     auto new_def = old_def->rebuild(world(), new_type, new_ops);
+    ++stats_.copied;
+    map(new_def);
     check_todo(old_def, new_def);
+}
+
+/// Sets the ops of the imported nominal once they are imported; returns @c false if some of them need to be imported first.
+bool Importer::fill(const Def* old_def) {
+    bool ready = true;
+    for (auto op : old_def->ops()) {
+        if (op != nullptr && !old2new_.contains(op)) {
+            stack_.emplace_back(op);
+            ready = false;
+        }
+    }
+    if (!ready) return false;
 
-    return checked_emplace(old2new_, old_def.def(), new_def);
+    auto new_nominal = const_cast<Def*>(old2new_[old_def]);
+    auto& info = nominals_[old_def];
+    DefArray new_ops(old_def->num_ops(), [&](size_t i) { return old_def->op(i) ? old2new_[old_def->op(i)] : nullptr; });
+    bool complete = std::all_of(new_ops.begin(), new_ops.end(), [](auto op) { return op != nullptr; });
+
+    if (info.filled && complete && std::all_of(new_nominal->ops().begin(), new_nominal->ops().end(), [](auto op) { return op != nullptr; })) {
+        for (size_t i = 0, e = new_nominal->num_ops(); i != e; ++i)
+            new_nominal->unset(i);
+        new_nominal->set(new_ops);
+    } else {
+        for (size_t i = 0, e = new_ops.size(); i != e; ++i) {
+            if (new_ops[i] != nullptr && new_nominal->op(i) == nullptr)
+                new_nominal->set(i, new_ops[i]);
+        }
+    }
+    check_todo(old_def, new_nominal);
+
+    info.filled = true;
+    info.fingerprint = fingerprint(old_def);
+    info.deps.reset();
+    // all nominals imported in the first round are fresh - nothing to check
+    if (round_ != 1) {
+        for (auto dep : deps(old_def, info))
+            checks_.emplace_back(dep);
+    }
+    return true;
+}
+
+/// Re-imports the ops of @p old_def if they changed since the last round; otherwise, checks the nominals it depends on.
+void Importer::check(const Def* old_def) {
+    auto i = nominals_.find(old_def);
+    if (i == nominals_.end()) return; // e.g. an Axiom
+    auto& info = i->second;
+    if (info.round == round_) return;
+    info.round = round_;
+
+    if (info.fingerprint != fingerprint(old_def)) {
+        ++stats_.refilled;
+        to_fill_.emplace_back(old_def);
+    } else {
+        for (auto dep : deps(old_def, info))
+            checks_.emplace_back(dep);
+    }
 }
 
 }
@@ -1,14 +1,36 @@
 #ifndef THORIN_TRANSFORM_IMPORT_H
 #define THORIN_TRANSFORM_IMPORT_H
 
+#include <memory>
+#include <optional>
+
 #include "thorin/world.h"
 
 namespace thorin {
 
+/**
+ * Imports @p Def%s into another @p World.
+ * @p Axiom%s and externals are identified by name:
+ * they are mapped to their counterparts in the target @p World if present.
+ * A declared but not yet defined external nominal in the target receives the ops of its imported definition.
+ * A counterpart of a different type or a second definition of an external raises a @p TypeError.
+ *
+ * The @p Importer works off explicit worklists and keeps its mapping across calls of @p import.
+ * Structural @p Def%s are immutable and, hence, imported only once.
+ * For each nominal, it records a fingerprint of its ops -
+ * as these are hash-consed, the fingerprint identifies the whole subgraph up to the next nominals.
+ * After @p next_round, @p import re-checks each reachable nominal once and only imports the ops of those nominals again whose fingerprint changed.
+ */
 class Importer {
 public:
+    struct Stats {
+        size_t copied = 0;   ///< @p Def%s rebuilt or stubbed in the target @p World.
+        size_t shared = 0;   ///< @p Def%s already known - from the target @p World or from a previous import.
+        size_t refilled = 0; ///< Nominals whose ops were imported again as their fingerprint changed.
+    };
+
     Importer(World& src)
-        : world_(src.name())
+        : Importer(std::make_unique<World>(src.name()))
     {
         //if  (src.is_pe_done())
             //world_.mark_pe_done();
@@ -17,17 +39,51 @@ public:
             world_.enable_history(true);
 #endif
     }
+    /// Imports into the existing @p dst.
+    static Importer into(World& dst) { return Importer(&dst); }
 
     World& world() { return world_; }
     const Def* import(Tracker);
+    /// Subsequent calls of @p import check again whether the nominals imported so far have changed.
+    void next_round() { ++round_; }
     bool todo() const { return todo_; }
+    const Stats& stats() const { return stats_; }
 
-public:
+private:
+    explicit Importer(std::unique_ptr<World> own)
+        : own_(std::move(own))
+        , world_(*own_)
+    {}
+    explicit Importer(World* dst)
+        : world_(*dst)
+    {}
+
+    struct Nominal {
+        u64 fingerprint = 0;
+        size_t round = 0;
+        bool filled = false;
+        std::optional<std::vector<const Def*>> deps; ///< Nominals reachable via the structural ops - computed on demand.
+    };
+
+    static u64 fingerprint(const Def*);
+    void run();
+    void step(const Def*);
+    bool fill(const Def*);
+    void check(const Def*);
     void check_todo(const Def*, const Def*);
+    std::vector<const Def*> collect_nominals(const Def*) const;
+    const std::vector<const Def*>& deps(const Def*, Nominal&) const;
 
     Def2Def old2new_;
-    World world_;
+    DefMap<Nominal> nominals_;
+    std::vector<const Def*> stack_;   ///< @p Def%s to import.
+    std::vector<const Def*> to_fill_; ///< Imported nominals whose ops need to be imported.
+    std::vector<const Def*> checks_;  ///< Already imported nominals to re-check in this round.
+    std::unique_ptr<World> own_;
+    World& world_;
+    size_t round_ = 1;
     bool todo_ = false;
+    Stats stats_;
 };
 
 }
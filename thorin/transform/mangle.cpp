@@ -1,6 +1,9 @@
 #include "thorin/transform/mangle.h"
 
+#include <algorithm>
+
 #include "thorin/world.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
@@ -10,18 +13,19 @@ Mangler::Mangler(const Scope& scope, Defs args, DefSet lift)
     , args_(args)
     , lift_(lift)
     , old_entry_(scope.entry())
-    , old2new_(scope.defs().capacity())
+    , old2new_(round_to_power_of_2(scope.defs().size()))
 {
     assert(!old_entry_->empty());
     //assert(arg->type() == old_entry_->type()->domain());
     assert(lift.empty() && "not yet implemented");
 #ifndef NDEBUG
     for (auto def : lift)
-        assert(scope.free().contains(def));
+        assert(scope.is_free(def));
 #endif
 }
 
 Lambda* Mangler::mangle() {
+    THORIN_TRACE("Mangler::mangle");
     DefVector param_types;
     for (size_t i = 0, e = args_.size(); i != e; ++i) {
         if (args_[i] == nullptr)
@@ -41,7 +45,7 @@ Lambda* Mangler::mangle() {
         else {
             auto new_param = new_entry_->param(j++);
             old2new_[old_param] = new_param;
-            new_param->debug().set(old_param->name());
+            new_param->set_name(old_param->name());
         }
     }
 
@@ -78,6 +82,143 @@ const Def* Mangler::mangle(const Def* old_def) {
 
 //------------------------------------------------------------------------------
 
+BatchMangler::BatchMangler(const Scope& scope)
+    : scope_(scope)
+    , old_entry_(scope.entry())
+    , defs_(scope.defs())
+    , mapped_(defs_.size(), true)
+{
+    assert(!old_entry_->empty());
+
+    // Iterative post-order DFS starting from the entry's ops.
+    // A structural Def depends on its type and its ops; a nominal only on its type as its stub suffices for its users.
+    // The entry itself is never rebuilt.
+    enum : uint8_t { Fresh, Active, Done };
+    Array<uint8_t> state(defs_.size(), Fresh);
+    std::vector<std::pair<uint32_t, size_t>> stack;
+    state[index(old_entry_)] = Done;
+
+    auto push = [&](const Def* def) {
+        auto i = index(def);
+        if (i == None) return;
+        assert((state[i] != Active || def->is_nominal()) && "cyclic dependency not broken by a nominal");
+        if (state[i] == Fresh) {
+            state[i] = Active;
+            stack.emplace_back(i, 0);
+        }
+    };
+
+    auto visit = [&](const Def* root) {
+        push(root);
+        while (!stack.empty()) {
+            auto& [i, o] = stack.back();
+            auto def = defs_[i];
+            size_t num = def->is_nominal() ? 0 : def->num_ops();
+
+            if (o == 0) {
+                ++o;
+                push(def->type());
+            } else if (o <= num) {
+                push(def->op(o++ - 1));
+            } else {
+                state[i] = Done;
+                order_.push_back(i);
+                stack.pop_back();
+            }
+        }
+    };
+
+    for (auto op : old_entry_->ops())
+        visit(op);
+
+    // the ops of the nominals reachable so far need to be rebuilt, too
+    for (size_t j = 0; j != order_.size(); ++j) {
+        auto def = defs_[order_[j]];
+        if (def->is_nominal()) {
+            for (auto op : def->ops())
+                visit(op);
+        }
+    }
+
+    // Structural Defs not depending on the entry's param are the same for all specializations:
+    // drop them from the plan and unmap them such that they are simply reused.
+    Array<bool> variant(defs_.size(), false);
+    if (auto i = index(old_entry_->param()); i != None)
+        variant[i] = true;
+    auto is_variant = [&](const Def* def) { auto i = index(def); return i != None && variant[i]; };
+
+    for (auto i : order_) {
+        auto def = defs_[i];
+        variant[i] = variant[i] || def->is_nominal() || is_variant(def->type())
+            || std::any_of(def->ops().begin(), def->ops().end(), is_variant);
+    }
+
+    order_.erase(std::remove_if(order_.begin(), order_.end(), [&](uint32_t i) { return !variant[i]; }), order_.end());
+    for (size_t i = 0, e = defs_.size(); i != e; ++i)
+        mapped_[i] = variant[i] || defs_[i] == old_entry_;
+}
+
+Lambda* BatchMangler::drop(Defs args) {
+    Array<const Def*> old2new(defs_.size());
+    auto lookup = [&](const Def* old_def) {
+        auto i = index(old_def);
+        return i == None ? old_def : old2new[i];
+    };
+
+    DefVector param_types;
+    for (size_t i = 0, e = args.size(); i != e; ++i) {
+        if (args[i] == nullptr)
+            param_types.emplace_back(old_entry_->param(i)->type());
+    }
+
+    auto new_pi = world().pi(old_entry_->qualifier(), world().sigma(param_types), old_entry_->codomain());
+    auto new_entry = world().lambda(new_pi, old_entry_->debug_history());
+
+    old2new[index(old_entry_)] = old_entry_;
+
+    // map params to args
+    for (size_t i = 0, j = 0, e = args.size(); i != e; ++i) {
+        auto old_param = old_entry_->param(i);
+        const Def* new_def = args[i];
+        if (new_def == nullptr) {
+            auto new_param = new_entry->param(j++);
+            new_param->set_name(old_param->name());
+            new_def = new_param;
+        }
+
+        if (auto k = index(old_param); k != None)
+            old2new[k] = new_def;
+    }
+
+    for (auto i : order_) {
+        if (old2new[i] != nullptr) continue;
+        auto old_def = defs_[i];
+        auto new_type = lookup(old_def->type());
+
+        if (old_def->is_nominal()) {
+            old2new[i] = old_def->stub(new_type);
+        } else {
+            DefArray new_ops(old_def->num_ops(), [&](size_t o) { return lookup(old_def->op(o)); });
+            old2new[i] = old_def->rebuild(world(), new_type, new_ops);
+        }
+    }
+
+    for (auto i : order_) {
+        auto old_def = defs_[i];
+        if (old_def->is_nominal()) {
+            auto new_nominal = const_cast<Def*>(old2new[i]);
+            for (size_t o = 0, e = old_def->num_ops(); o != e; ++o) {
+                if (auto op = old_def->op(o))
+                    new_nominal->set(o, lookup(op));
+            }
+        }
+    }
+
+    return new_entry->set(lookup(old_entry_->filter()), lookup(old_entry_->body()));
+}
+
+//------------------------------------------------------------------------------
+
 Lambda* mangle(const Scope& scope, Defs args, DefSet lift) {
     return Mangler(scope, args, lift).mangle();
 }
@@ -28,6 +28,39 @@ private:
     Def2Def old2new_;
 };
 
+/**
+ * Specializes the entry of a @p Scope for many argument lists.
+ * The @p Scope and the rebuild order of the @p Def%s reachable from the entry are computed once and shared by all specializations.
+ * Structural @p Def%s not depending on the entry's parameters are reused as they are.
+ * Each specialization then boils down to a single linear sweep with a dense old-to-new map - no recursion, no hashing.
+ * Like @p drop, an argument @c nullptr keeps the corresponding parameter.
+ */
+class BatchMangler {
+public:
+    BatchMangler(const BatchMangler&) = delete;
+    BatchMangler& operator=(BatchMangler) = delete;
+
+    explicit BatchMangler(const Scope& scope);
+
+    const Scope& scope() const { return scope_; }
+    World& world() const { return scope_.world(); }
+    Lambda* drop(Defs args);
+
+private:
+    static constexpr uint32_t None = uint32_t(-1);
+
+    /// Dense index of @p def within the Scope or @p None if @p def is reused as it is.
+    uint32_t index(const Def* def) const {
+        auto i = def != nullptr ? scope_.index(def) : Scope::None;
+        return i != Scope::None && mapped_[i] ? uint32_t(i) : None;
+    }
+
+    const Scope& scope_;
+    Lambda* old_entry_;
+    ArrayRef<const Def*> defs_;     ///< Maps dense index to Def.
+    Array<bool> mapped_;            ///< Which Def%s need to be looked up in the old-to-new map.
+    std::vector<uint32_t> order_;   ///< Dense indices of the Def%s to rebuild such that dependencies come first.
+};
 
 Lambda* mangle(const Scope&, Defs args, DefSet lift);
 
@@ -60,6 +60,7 @@ public:
     void visit_op(const Def*, size_t, DefArray& new_ops, size_t index, const Def* result) { new_ops[index] = result; }
     const Def* visit_post_ops(const Def* def, size_t offset, const Def* new_type, DefArray& new_ops) {
         auto new_def = def->rebuild(world(), new_type, new_ops);
+        THORIN_STATS(++world().counters().reduce_rebuilt);
         return map_[{def, offset}] = new_def;
     }
 
@@ -80,6 +81,7 @@ const Def* reduce(const Def* def, Defs args, size_t index) {
     if (def->free_vars().none_begin(index))
         return def;
 
+    THORIN_STATS(++def->world().counters().reduce_calls);
     Reducer reducer(def->world(), args);
     return visit_free_vars_params<Reducer, const Def*>(reducer, def, index);
 }
@@ -96,6 +98,7 @@ const Def* shift_free_vars(const Def* def, int64_t shift) {
     assertf(shift > 0 || def->free_vars().none_end(-shift),
             "can't shift {} by {}, there are variables with index <= {}", def, shift, -shift);
 
+    THORIN_STATS(++def->world().counters().reduce_calls);
     Reducer reducer(def->world(), -shift);
     return visit_free_vars_params<Reducer, const Def*>(reducer, def, 0);
 }
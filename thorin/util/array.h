@@ -2,6 +2,7 @@
 #define THORIN_UTIL_ARRAY_H
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
@@ -9,6 +10,8 @@
 #include <iostream>
 #include <iterator>
 #include <functional>
+#include <new>
+#include <type_traits>
 #include <vector>
 
 #include "thorin/util/stream.h"
@@ -113,6 +116,8 @@ std::ostream& operator<<(std::ostream& os, const ArrayRef<T> a) {
  *    But once shrunk, there is no way back.
  *  - Because of this @p Array is slightly more lightweight and usually consumes slightly less memory than <tt>std::vector</tt>.
  *  - @p Array integrates nicely with the usefull @p ArrayRef container.
+ *  - Small arrays of trivial types - like most @p DefArray%s - are stored inline without any heap allocation.
+ *    Thus, moving an @p Array invalidates pointers into it in this case.
  */
 template<class T>
 class Array {
@@ -123,66 +128,79 @@ public:
     typedef std::reverse_iterator<iterator> reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
+    /// Number of elements stored inline - four pointers worth of trivial elements.
+    static constexpr size_t Inline = std::is_trivial<T>::value && sizeof(T) <= 4 * sizeof(void*) ? 4 * sizeof(void*) / sizeof(T) : 0;
+
     Array()
         : size_(0)
         , ptr_(nullptr)
     {}
     explicit Array(size_t size)
         : size_(size)
-        , ptr_(new T[size]())
-    {}
+        , ptr_(allocate(size))
+    {
+        if constexpr (std::is_trivial<T>::value)
+            std::fill(begin(), end(), T());
+    }
     Array(size_t size, const T& val)
         : size_(size)
-        , ptr_(new T[size])
+        , ptr_(allocate(size))
     {
         std::fill(begin(), end(), val);
     }
     Array(ArrayRef<T> ref)
         : size_(ref.size())
-        , ptr_(new T[ref.size()])
+        , ptr_(allocate(ref.size()))
     {
         std::copy(ref.begin(), ref.end(), this->begin());
     }
     Array(Array&& other)
-        : size_(std::move(other.size_))
-        , ptr_(std::move(other.ptr_))
+        : size_(other.size_)
+        , ptr_(other.is_inline() ? inline_.data() : other.ptr_)
     {
+        if constexpr (Inline != 0) {
+            if (is_inline())
+                std::copy(other.begin(), other.end(), this->begin());
+        }
         other.ptr_ = nullptr;
         other.size_ = 0;
     }
     Array(const Array& other)
         : size_(other.size())
-        , ptr_(new T[other.size()])
+        , ptr_(allocate(other.size()))
     {
         std::copy(other.begin(), other.end(), this->begin());
     }
     Array(const std::vector<T>& other)
         : size_(other.size())
-        , ptr_(new T[other.size()])
+        , ptr_(allocate(other.size()))
     {
         std::copy(other.begin(), other.end(), this->begin());
     }
     template<class I>
     Array(const I begin, const I end)
         : size_(std::distance(begin, end))
-        , ptr_(new T[size_])
+        , ptr_(allocate(size_))
     {
         std::copy(begin, end, ptr_);
     }
     Array(std::initializer_list<T> list)
         : size_(std::distance(list.begin(), list.end()))
-        , ptr_(new T[size_])
+        , ptr_(allocate(size_))
     {
         std::copy(list.begin(), list.end(), ptr_);
     }
-    Array(size_t size, std::function<T(size_t)> f)
-        : Array(size)
+    /// Initializes the @p i-th element with <tt>f(i)</tt>.
+    template<class F, class = std::enable_if_t<std::is_invocable_r_v<T, F&, size_t>>>
+    Array(size_t size, F f)
+        : size_(size)
+        , ptr_(allocate(size))
     {
         for (size_t i = 0; i != size; ++i)
-            (*this)[i] = f(i);
+            ptr_[i] = f(i);
     }
 
-    ~Array() { delete[] ptr_; }
+    ~Array() { if (!is_inline()) delete[] ptr_; }
 
     iterator begin() { return ptr_; }
     iterator end() { return ptr_ + size_; }
@@ -214,13 +232,26 @@ public:
 
     friend void swap(Array& a, Array& b) {
         using std::swap;
-        swap(a.size_, b.size_);
-        swap(a.ptr_,  b.ptr_);
+        if (Inline == 0 || (!a.is_inline() && !b.is_inline())) {
+            swap(a.size_, b.size_);
+            swap(a.ptr_,  b.ptr_);
+        } else if constexpr (Inline != 0) {
+            Array tmp(std::move(a));
+            a.~Array();
+            new (&a) Array(std::move(b));
+            b.~Array();
+            new (&b) Array(std::move(tmp));
+        }
     }
 
 private:
+    bool is_inline() const { return Inline != 0 && ptr_ == inline_.data(); }
+    /// Does not initialize trivial elements.
+    T* allocate(size_t size) { return size == 0 ? nullptr : size <= Inline ? inline_.data() : new T[size]; }
+
     size_t size_;
     T* ptr_;
+    std::array<T, Inline> inline_;
 };
 
 template<class T>
@@ -1,18 +1,159 @@
 #include "thorin/util/bitset.h"
+#include "thorin/util/hash.h"
 #include "thorin/util/stream.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace thorin {
 
+//------------------------------------------------------------------------------
+
+/*
+ * word-parallel kernels - with an AVX2 path for four words at a time if enabled via THORIN_ENABLE_AVX2
+ */
+
+namespace {
+
+enum class Op { And, Or, Xor };
+
+template<Op op>
+uint64_t apply(uint64_t a, uint64_t b) {
+    switch (op) {
+        case Op::And: return a & b;
+        case Op::Or:  return a | b;
+        case Op::Xor: return a ^ b;
+    }
+    THORIN_UNREACHABLE;
+}
+
+#ifdef __AVX2__
+template<Op op>
+__m256i apply(__m256i a, __m256i b) {
+    switch (op) {
+        case Op::And: return _mm256_and_si256(a, b);
+        case Op::Or:  return _mm256_or_si256 (a, b);
+        case Op::Xor: return _mm256_xor_si256(a, b);
+    }
+    THORIN_UNREACHABLE;
+}
+
+__m256i load(const uint64_t* w) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w)); }
+void store(uint64_t* w, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(w), v); }
+#endif
+
+/// <tt>dst[i] = dst[i] op src[i]</tt> for all @c i in @c [0,n[
+template<Op op>
+void apply(uint64_t* dst, const uint64_t* src, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+        store(dst + i, apply<op>(load(dst + i), load(src + i)));
+#endif
+    for (; i != n; ++i)
+        dst[i] = apply<op>(dst[i], src[i]);
+}
+
+/// Is any bit in @c [w,w+n[ set?
+bool any_words(const uint64_t* w, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+        auto v = load(w + i);
+        if (!_mm256_testz_si256(v, v))
+            return true;
+    }
+#endif
+    uint64_t result = 0;
+    for (; i != n; ++i)
+        result |= w[i];
+    return result != 0;
+}
+
+/// Is any bit in both @c [a,a+n[ and @c [b,b+n[ set?
+bool intersect_words(const uint64_t* a, const uint64_t* b, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+        if (!_mm256_testz_si256(load(a + i), load(b + i)))
+            return true;
+    }
+#endif
+    uint64_t result = 0;
+    for (; i != n; ++i)
+        result |= a[i] & b[i];
+    return result != 0;
+}
+
+/// The @p i-th word of @p w shifted right by @p div words and @p rem bits; words beyond @p n are zero.
+inline uint64_t shr_word(const uint64_t* w, size_t n, size_t i, uint64_t div, uint64_t rem) {
+    size_t j = i + div;
+    uint64_t lo = j     < n ? w[j]     : 0;
+    uint64_t hi = j + 1 < n ? w[j + 1] : 0;
+    return rem == 0 ? lo : (lo >> rem) | (hi << (64_u64 - rem));
+}
+
+}
+
+//------------------------------------------------------------------------------
+
 void BitSet::dealloc() const {
     if (num_words_ != 1)
         delete[] words_;
 }
 
 size_t BitSet::count() const {
-    size_t result = 0;
     auto w = words();
-    for (size_t i = 0, e = num_words(); i != e; ++i)
-        result += bitcount(w[i]);
+    size_t n = num_words(), i = 0;
+    // independent accumulators keep several popcounts in flight
+    size_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+    for (; i + 4 <= n; i += 4) {
+        r0 += bitcount(w[i + 0]);
+        r1 += bitcount(w[i + 1]);
+        r2 += bitcount(w[i + 2]);
+        r3 += bitcount(w[i + 3]);
+    }
+    for (; i != n; ++i)
+        r0 += bitcount(w[i]);
+    return r0 + r1 + r2 + r3;
+}
+
+size_t BitSet::find_first() const {
+    auto w = words();
+    for (size_t i = 0, e = num_words(); i != e; ++i) {
+        if (w[i] != 0)
+            return i*64_s + trailing_zeros(w[i]);
+    }
+    return size_t(-1);
+}
+
+size_t BitSet::find_last() const {
+    auto w = words();
+    for (size_t i = num_words(); i-- != 0;) {
+        if (w[i] != 0)
+            return i*64_s + 63_s - leading_zeros(w[i]);
+    }
+    return size_t(-1);
+}
+
+bool BitSet::operator==(const BitSet& other) const {
+    auto  this_words = this->words();
+    auto other_words = other.words();
+    size_t n = std::min(this->num_words(), other.num_words());
+    return std::equal(this_words, this_words + n, other_words)
+        && !any_words( this_words + n, this->num_words() - n)
+        && !any_words(other_words + n, other.num_words() - n);
+}
+
+uint64_t BitSet::hash() const {
+    auto w = words();
+    size_t n = num_words();
+    while (n != 0 && w[n-1] == 0) --n;
+
+    uint64_t result = hash_begin(n);
+    for (size_t i = 0; i != n; ++i)
+        result = hash_combine(result, w[i]);
     return result;
 }
 
@@ -20,52 +161,109 @@ inline static uint64_t begin_mask(uint64_t i) { return -1_u64 << (i % 64_u64); }
 inline static uint64_t   end_mask(uint64_t i) { return ~begin_mask(i); }
 
 bool BitSet::any_range(const size_t begin, size_t end) const {
+    end = std::min(end, num_bits());
     if (begin >= end)
         return false;
 
-    end = std::min(end, num_bits());
+    auto w = words();
     size_t i = begin / 64_s;
     size_t e =   end / 64_s;
     auto bmask = begin_mask(begin);
     auto emask =   end_mask(  end);
 
     // if i and e are within the same word
-    if (i == e) return words()[i] & bmask & emask;
+    if (i == e) return w[i] & bmask & emask;
 
-    // use bmask for the first word
-    bool result = (words()[i++] & bmask);
-
-    // all other words except the last one
-    for (; !result && i != e; ++i)
-        result |= words()[i];
+    // use bmask for the first word, check all other words except the last one at once
+    if ((w[i] & bmask) || any_words(w + i + 1, e - i - 1))
+        return true;
 
     // only use emask if there actually *is* an emask - otherwise we are getting out of bounds
-    return result || (emask && (words_[i] & emask));
+    return emask && (w[e] & emask);
 }
 
 BitSet& BitSet::operator>>=(uint64_t shift) {
     uint64_t div = shift/64_u64;
     uint64_t rem = shift%64_u64;
     auto w = words();
+    size_t n = num_words();
+
+    if (div >= n) {
+        std::fill_n(w, n, 0);
+    } else {
+        // ascending: word i only reads words >= i
+        for (size_t i = 0; i != n; ++i)
+            w[i] = shr_word(w, n, i, div, rem);
+    }
+
+    return *this;
+}
+
+BitSet& BitSet::operator<<=(uint64_t shift) {
+    auto last = find_last();
+    if (last == size_t(-1) || shift == 0)
+        return *this;
+
+    ensure_capacity(last + shift);
+    uint64_t div = shift/64_u64;
+    uint64_t rem = shift%64_u64;
+    auto w = words();
+    size_t n = num_words();
 
-    if (div >= num_words())
-        clear();
-    else {
-        for (size_t i = 0, e = num_words()-div; i != e; ++i)
-            w[i] = w[i+div];
-        std::fill(w+num_words()-div, w+num_words(), 0);
-
-        uint64_t carry = 0;
-        for (size_t i = num_words()-div; i-- != 0;) {
-            uint64_t new_carry = w[i] << (64_u64-rem);
-            w[i] = (w[i] >> rem) | carry;
-            carry = new_carry;
-        }
+    // descending: word i only reads words <= i
+    for (size_t i = n; i-- != 0;) {
+        uint64_t hi = i >= div     ? w[i - div]     : 0;
+        uint64_t lo = i >= div + 1 ? w[i - div - 1] : 0;
+        w[i] = rem == 0 ? hi : (hi << rem) | (lo >> (64_u64 - rem));
     }
 
     return *this;
 }
 
+BitSet& BitSet::operator&=(const BitSet& other) {
+    size_t n = std::min(this->num_words(), other.num_words());
+    apply<Op::And>(this->words(), other.words(), n);
+    std::fill(this->words() + n, this->words() + this->num_words(), 0);
+    return *this;
+}
+
+BitSet& BitSet::operator|=(const BitSet& other) {
+    if (this->num_words() < other.num_words())
+        this->ensure_capacity(other.num_bits()-1);
+    apply<Op::Or>(this->words(), other.words(), other.num_words());
+    return *this;
+}
+
+BitSet& BitSet::operator^=(const BitSet& other) {
+    if (this->num_words() < other.num_words())
+        this->ensure_capacity(other.num_bits()-1);
+    apply<Op::Xor>(this->words(), other.words(), other.num_words());
+    return *this;
+}
+
+BitSet& BitSet::or_shr(const BitSet& other, uint64_t shift) {
+    if (shift == 0 || this == &other)
+        return *this |= other >> shift;
+
+    uint64_t div = shift/64_u64;
+    uint64_t rem = shift%64_u64;
+    size_t n = other.num_words();
+    if (div >= n)
+        return *this;
+
+    if (this->num_words() < n - div)
+        this->ensure_capacity((n - div)*64_s - 1);
+    auto dst = this->words();
+    auto src = other.words();
+    for (size_t i = 0, e = n - div; i != e; ++i)
+        dst[i] |= shr_word(src, n, i, div, rem);
+    return *this;
+}
+
+bool BitSet::intersects(const BitSet& other) const {
+    return intersect_words(this->words(), other.words(), std::min(this->num_words(), other.num_words()));
+}
+
 void BitSet::ensure_capacity(size_t i) const {
     size_t num_new_words = (i+64_s) / 64_s;
     if (num_new_words > num_words_) {
@@ -97,21 +97,44 @@ public:
 
     //@{ shift
     BitSet& operator>>=(uint64_t shift);
+    BitSet& operator<<=(uint64_t shift);
     BitSet operator>>(uint64_t shift) const { BitSet res(*this); res >>= shift; return res; }
-    // TODO left shift
+    BitSet operator<<(uint64_t shift) const { BitSet res(*this); res <<= shift; return res; }
     //@}
 
     //@{ boolean operators
-    BitSet& operator&=(const BitSet& other) { return op_assign<std::bit_and<uint64_t>>(other); }
-    BitSet& operator|=(const BitSet& other) { return op_assign<std::bit_or <uint64_t>>(other); }
-    BitSet& operator^=(const BitSet& other) { return op_assign<std::bit_xor<uint64_t>>(other); }
-    BitSet operator&(BitSet b) const { BitSet res(*this); res &= b; return res; }
-    BitSet operator|(BitSet b) const { BitSet res(*this); res |= b; return res; }
-    BitSet operator^(BitSet b) const { BitSet res(*this); res ^= b; return res; }
+    BitSet& operator&=(const BitSet& other);
+    BitSet& operator|=(const BitSet& other);
+    BitSet& operator^=(const BitSet& other);
+    BitSet operator&(const BitSet& b) const { BitSet res(*this); res &= b; return res; }
+    BitSet operator|(const BitSet& b) const { BitSet res(*this); res |= b; return res; }
+    BitSet operator^(const BitSet& b) const { BitSet res(*this); res ^= b; return res; }
+    //@}
+
+    /// @name fused operations
+    /// These avoid the temporary @p BitSet of their unfused counterparts.
+    //@{
+    /// <tt>*this |= other >> shift</tt>
+    BitSet& or_shr(const BitSet& other, uint64_t shift);
+    /// <tt>(*this >> shift).any_range(begin, end)</tt>
+    bool any_range_shr(uint64_t shift, size_t begin, size_t end) const {
+        return shift < num_bits() && any_range(begin + shift, end > num_bits() - shift ? num_bits() : end + shift);
+    }
+    /// <tt>(*this & other).any()</tt>
+    bool intersects(const BitSet& other) const;
     //@}
 
     /// number of bits set
     size_t count() const;
+    /// index of the lowest/highest bit set - @c size_t(-1) if none is set
+    size_t find_first() const;
+    size_t find_last() const;
+
+    //@{ comparison and hashing - trailing zero words do not matter
+    bool operator==(const BitSet& other) const;
+    bool operator!=(const BitSet& other) const { return !(*this == other); }
+    uint64_t hash() const;
+    //@}
 
     void friend swap(BitSet& b1, BitSet& b2) {
         using std::swap;
@@ -124,17 +147,6 @@ public:
     void ensure_capacity(size_t num_bits) const;
 
 private:
-    template<class F>
-    BitSet& op_assign(const BitSet& other) {
-        if (this->num_words() < other.num_words())
-            this->ensure_capacity(other.num_bits()-1);
-        auto  this_words = this->words();
-        auto other_words = other.words();
-        for (size_t i = 0, e = other.num_words(); i != e; ++i)
-            this_words[i] = F()(this_words[i], other_words[i]);
-        return *this;
-    }
-
     void dealloc() const;
     const uint64_t* words() const { return num_words_ == 1 ? &word_ : words_; }
     uint64_t* words() { return num_words_ == 1 ? &word_ : words_; }
@@ -3,6 +3,25 @@
 
 namespace thorin {
 
+uint64_t DebugTable::DebugHash::hash(const Debug& dbg) {
+    return murmur3(hash_combine(hash_begin(dbg.filename()), dbg.front_line(), dbg.front_col(), dbg.back_line(), dbg.back_col(), dbg.name().hash()));
+}
+
+uint32_t DebugTable::intern(const Debug& debug) {
+#ifdef THORIN_DROP_DEBUG_LOCS
+    Debug dbg(debug.name());
+#else
+    const Debug& dbg = debug;
+#endif
+    if (!dbg.is_set() && dbg.name().empty())
+        return 0;
+
+    auto [i, inserted] = handles_.emplace(dbg, uint32_t(debugs_.size()));
+    if (inserted)
+        debugs_.emplace_back(dbg);
+    return i->second;
+}
+
 Loc& Loc::operator+=(Loc other) {
     this->back_line_ = other.back_line_;
     this->back_col_  = other.back_col_;
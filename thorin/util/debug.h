@@ -1,6 +1,7 @@
 #ifndef THORIN_UTIL_DEBUG_H
 #define THORIN_UTIL_DEBUG_H
 
+#include <deque>
 #include <ostream>
 #include <string>
 
@@ -80,6 +81,50 @@ private:
     Symbol name_;
 };
 
+//------------------------------------------------------------------------------
+
+/**
+ * Interns @p Debug infos such that a @p Def merely keeps a 32-bit handle.
+ * Handle @c 0 is the empty @p Debug.
+ * Most @p Def%s share the empty @p Debug or the one of the @p Def they are built from.
+ * If @c THORIN_DROP_DEBUG_LOCS is defined, only names are kept.
+ */
+class DebugTable {
+public:
+    DebugTable(const DebugTable&) = delete;
+    DebugTable& operator=(const DebugTable&) = delete;
+
+    DebugTable()
+        : debugs_(1)
+    {}
+
+    uint32_t intern(const Debug&);
+    /// Remembers the @p Debug of a structural @p Def until @p World::unify knows whether the @p Def survives.
+    void defer(const Debug& dbg) { deferred_ = dbg; }
+    uint32_t intern_deferred() { return intern(deferred_); }
+    /// The reference stays valid for the lifetime of this table.
+    const Debug& operator[](uint32_t handle) const { return debugs_[handle]; }
+    size_t size() const { return debugs_.size(); }
+
+    friend void swap(DebugTable& t1, DebugTable& t2) {
+        using std::swap;
+        swap(t1.debugs_,   t2.debugs_);
+        swap(t1.handles_,  t2.handles_);
+        swap(t1.deferred_, t2.deferred_);
+    }
+
+private:
+    struct DebugHash {
+        static uint64_t hash(const Debug&);
+        static bool eq(const Debug& d1, const Debug& d2) { return d1 == d2 && d1.name() == d2.name(); }
+        static Debug sentinel() { return Debug(Loc(reinterpret_cast<const char*>(1), 0, 0)); }
+    };
+
+    std::deque<Debug> debugs_;
+    HashMap<Debug, uint32_t, DebugHash> handles_;
+    Debug deferred_;
+};
+
 inline Debug operator+(Debug dbg, Symbol s)             { return {dbg, dbg.name() + s}; }
 inline Debug operator+(Debug dbg, const char* s)        { return {dbg, dbg.name() + s}; }
 inline Debug operator+(Debug dbg, const std::string& s) { return {dbg, dbg.name() + s}; }
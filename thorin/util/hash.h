@@ -218,6 +218,20 @@ public:
     //@{ getters
     size_t capacity() const { return capacity_; }
     size_t size() const { return size_; }
+    /// Sum and maximum of the probe distances of all elements - to judge the quality of the hash function.
+    std::pair<size_t, size_t> probe_lengths() const {
+        size_t sum = 0, max = 0;
+        if (on_heap()) { // otherwise, this is a plain array
+            for (size_t i = 0; i != capacity_; ++i) {
+                if (!is_invalid(nodes_+i)) {
+                    auto distance = probe_distance(i);
+                    sum += distance;
+                    max = std::max(max, distance);
+                }
+            }
+        }
+        return {sum, max};
+    }
     bool empty() const { return size() == 0; }
     //@}
 
@@ -469,7 +483,7 @@ private:
     uint64_t hash(size_t i) { return H::hash(key(&nodes_[i])); } ///< just for debugging
     size_t mod(size_t i) const { return i & (capacity_-1); }
     size_t desired_pos(const key_type& key) const { return mod(H::hash(key)); }
-    size_t probe_distance(size_t i) { return mod(i + capacity() - desired_pos(key(nodes_+i))); }
+    size_t probe_distance(size_t i) const { return mod(i + capacity() - desired_pos(key(nodes_+i))); }
     value_type* end_ptr() const { return nodes_ + capacity(); }
     bool on_heap() const { return capacity_ != StackCapacity; }
 
@@ -9,6 +9,7 @@
 
 #include "thorin/util/debug.h"
 #include "thorin/util/stream.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
@@ -42,7 +43,15 @@ public:
                               << colorize(oss.str(), 7) << ": ";
             if (level == Debug)
                 Log::stream() << "  ";
-            streamf(Log::stream(), fmt, std::forward<Args>(args)...);
+            if (Trace::enabled()) {
+                // also record the line as an instant event on the trace's timeline
+                std::ostringstream msg;
+                streamf(msg, fmt, args...);
+                Trace::instant(msg.str());
+                Log::stream() << msg.str();
+            } else {
+                streamf(Log::stream(), fmt, std::forward<Args>(args)...);
+            }
             Log::stream() << std::endl;
         }
     }
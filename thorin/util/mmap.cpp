@@ -0,0 +1,66 @@
+#include "thorin/util/mmap.h"
+
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace thorin {
+
+#ifdef _MSC_VER
+
+MappedFile::MappedFile(const char* filename)
+    : filename_(filename)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs) throw std::runtime_error("cannot open file '" + filename_ + "'");
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    buffer_ = oss.str();
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() {}
+
+#else // _MSC_VER
+
+MappedFile::MappedFile(const char* filename)
+    : filename_(filename)
+{
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open file '" + filename_ + "'");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat file '" + filename_ + "'");
+    }
+
+    size_ = size_t(st.st_size);
+    if (size_ != 0) {
+        auto addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot map file '" + filename_ + "'");
+        }
+        data_ = static_cast<const char*>(addr);
+    }
+    ::close(fd); // the mapping stays valid
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr)
+        ::munmap(const_cast<char*>(data_), size_);
+}
+
+#endif // _MSC_VER
+
+}
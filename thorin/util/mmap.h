@@ -0,0 +1,36 @@
+#ifndef THORIN_UTIL_MMAP_H
+#define THORIN_UTIL_MMAP_H
+
+#include <string>
+#include <string_view>
+
+namespace thorin {
+
+/**
+ * Maps a file read-only into memory.
+ * Falls back to reading the whole file into a buffer if memory mapping is not available.
+ * Throws @c std::runtime_error if the file cannot be opened.
+ */
+class MappedFile {
+public:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile) = delete;
+
+    explicit MappedFile(const char* filename);
+    ~MappedFile();
+
+    const char* filename() const { return filename_.c_str(); }
+    std::string_view view() const { return {data_, size_}; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    std::string filename_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::string buffer_; ///< Only used if memory mapping is not available.
+};
+
+}
+
+#endif
@@ -1,25 +1,174 @@
 #include "thorin/util/symbol.h"
 
+#include <atomic>
+#include <cstddef>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
+#include <vector>
 
 namespace thorin {
 
-Symbol::Table Symbol::table_;
+static uint64_t hash(std::string_view s) {
+    uint64_t seed = thorin::hash_begin();
+    for (auto c : s)
+        seed = thorin::hash_combine(seed, c);
+    return seed;
+}
+
+static_assert(offsetof(Symbol::Header, size) + sizeof(uint32_t) <= sizeof(Symbol::Header));
+const Symbol::Empty Symbol::empty_ = {{FNV1::offset, 0}, {'\0'}};
+
+namespace {
+
+/**
+ * One of the shards of the global table.
+ * Each shard owns an open-addressing table of atomic pointers to the interned strings and an arena holding them.
+ * Readers probe the current slot array without locking.
+ * Writers lock the shard, insert with release semantics and, if necessary, publish a grown slot array.
+ * Replaced slot arrays are retired but kept alive as concurrent readers may still probe them.
+ */
+class Shard {
+public:
+    Shard() { slots_ = grow(nullptr, 64); }
+    ~Shard() {
+        for (auto slots : retired_) free(slots);
+        for (auto page : pages_) free(page);
+    }
+
+    const char* find(std::string_view str, uint64_t hash) const {
+        return probe(slots_.load(std::memory_order_acquire), str, hash);
+    }
+
+    const char* insert(std::string_view str, uint64_t hash) {
+        if (auto result = find(str, hash)) return result;
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto slots = slots_.load(std::memory_order_relaxed);
+        if (auto result = probe(slots, str, hash)) return result; // someone else was faster
+
+        if (4 * (size_ + 1) > 3 * slots->capacity)
+            slots_.store(slots = grow(slots, 2 * slots->capacity), std::memory_order_release);
+
+        auto result = allocate(str, hash);
+        place(slots, result, hash);
+        ++size_;
+        return result;
+    }
+
+    size_t size() const { std::lock_guard<std::mutex> guard(mutex_); return size_; }
+
+private:
+    struct Slots {
+        size_t capacity;
+        std::atomic<const char*> slots[1];
+    };
+
+    static const Symbol::Header& header(const char* str) { return reinterpret_cast<const Symbol::Header*>(str)[-1]; }
+
+    static const char* probe(const Slots* slots, std::string_view str, uint64_t hash) {
+        for (size_t i = hash, mask = slots->capacity - 1;; ++i) {
+            auto s = slots->slots[i & mask].load(std::memory_order_acquire);
+            if (s == nullptr) return nullptr;
+            auto& h = header(s);
+            if (h.hash == hash && h.size == str.size() && std::memcmp(s, str.data(), str.size()) == 0)
+                return s;
+        }
+    }
+
+    static void place(Slots* slots, const char* str, uint64_t hash) {
+        for (size_t i = hash, mask = slots->capacity - 1;; ++i) {
+            auto& slot = slots->slots[i & mask];
+            if (slot.load(std::memory_order_relaxed) == nullptr) {
+                slot.store(str, std::memory_order_release);
+                return;
+            }
+        }
+    }
 
-#ifdef _MSC_VER
-static const char* duplicate(const char* s) { return _strdup(s); }
-#else // _MSC_VER
-static const char* duplicate(const char* s) { return strdup(s); }
-#endif // _MSC_VER
+    Slots* grow(Slots* old, size_t capacity) {
+        auto slots = static_cast<Slots*>(malloc(sizeof(Slots) + (capacity - 1) * sizeof(std::atomic<const char*>)));
+        slots->capacity = capacity;
+        for (size_t i = 0; i != capacity; ++i)
+            new (&slots->slots[i]) std::atomic<const char*>(nullptr);
 
-void Symbol::insert(const char* s) {
-    auto i = table_.set.find(s);
-    if (i == table_.set.end())
-        i = table_.set.emplace(duplicate(s)).first;
-    str_ = *i;
+        if (old != nullptr) {
+            for (size_t i = 0; i != old->capacity; ++i) {
+                if (auto s = old->slots[i].load(std::memory_order_relaxed))
+                    place(slots, s, header(s).hash);
+            }
+        }
+        retired_.push_back(slots);
+        return slots;
+    }
+
+    const char* allocate(std::string_view str, uint64_t hash) {
+        constexpr size_t Align = alignof(Symbol::Header);
+        size_t num_bytes = (sizeof(Symbol::Header) + str.size() + 1 + Align - 1) & ~(Align - 1);
+
+        if (index_ + num_bytes > PageSize) {
+            pages_.push_back(static_cast<char*>(malloc(std::max(PageSize, num_bytes)))); // oversized pages are used up right away
+            index_ = 0;
+        }
+
+        auto buffer = pages_.back() + index_;
+        index_ += num_bytes;
+        new (buffer) Symbol::Header{hash, uint32_t(str.size())};
+        auto result = buffer + sizeof(Symbol::Header);
+        std::memcpy(result, str.data(), str.size());
+        result[str.size()] = '\0';
+        return result;
+    }
+
+    static constexpr size_t PageSize = 64 * 1024;
+
+    mutable std::mutex mutex_;
+    std::atomic<Slots*> slots_;
+    size_t size_ = 0;
+    std::vector<Slots*> retired_; ///< All slot arrays ever allocated - including the current one.
+    std::vector<char*> pages_;
+    size_t index_ = PageSize;
+};
+
+class Table {
+public:
+    static constexpr size_t NumShards = 64;
+
+    Shard& shard(uint64_t hash) { return shards_[murmur3(hash) % NumShards]; }
+    size_t size() const {
+        size_t result = 0;
+        for (auto& shard : shards_) result += shard.size();
+        return result;
+    }
+
+private:
+    std::array<Shard, NumShards> shards_;
+};
+
+/// Never destroyed: @p Symbol%s in other static objects may outlive any static @p Table.
+Table& table() {
+    static auto table = new Table();
+    return *table;
 }
 
+}
+
+const char* Symbol::insert(std::string_view str) {
+    if (str.empty()) return empty_.str;
+    auto h = thorin::hash(str);
+    return table().shard(h).insert(str, h);
+}
+
+std::optional<Symbol> Symbol::lookup(std::string_view str) {
+    if (str.empty()) return Symbol();
+    auto h = thorin::hash(str);
+    if (auto result = table().shard(h).find(str, h))
+        return Symbol(result, 0);
+    return std::nullopt;
+}
+
+size_t Symbol::num() { return table().size(); }
+
 std::string Symbol::remove_quotation() const {
     std::string str = str_;
     if (!str.empty() && str.front() == '"') {
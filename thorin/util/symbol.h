@@ -1,56 +1,79 @@
 #ifndef THORIN_UTIL_SYMBOL_H
 #define THORIN_UTIL_SYMBOL_H
 
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "thorin/util/hash.h"
 
 namespace thorin {
 
+/**
+ * An interned string.
+ * All @p Symbol%s live in a global, thread-safe table:
+ * The strings are allocated in arenas right behind a small header holding their precomputed hash and size.
+ * Lookups are lock-free; only inserting a new string locks one of several shards.
+ * Comparing two @p Symbol%s is a pointer comparison; comparing against a string never allocates.
+ */
 class Symbol {
 public:
     struct Hash {
-        static uint64_t hash(Symbol s) { return thorin::hash(s.c_str()); }
+        static uint64_t hash(Symbol s) { return s.hash(); }
         static bool eq(Symbol s1, Symbol s2) { return s1 == s2; }
         static Symbol sentinel() { return Symbol(/*dummy*/23); }
     };
 
-    Symbol() { insert(""); }
-    Symbol(const char* str) { insert(str); }
-    Symbol(const std::string& str) { insert(str.c_str()); }
+    Symbol() : str_(empty_.str) {}
+    Symbol(std::string_view str) : str_(insert(str)) {}
+    Symbol(const char* str) : Symbol(std::string_view(str)) {}
+    Symbol(const std::string& str) : Symbol(std::string_view(str)) {}
     Symbol(Symbol&&) = default;
     Symbol(const Symbol&) = default;
     Symbol& operator=(const Symbol&) = default;
 
     const char* c_str() const { return str_; }
     std::string str() const { return str_; }
-    operator bool() const { return *this != Symbol(""); }
+    std::string_view view() const { return {str_, header().size}; }
+    size_t size() const { return header().size; }
+    uint64_t hash() const { return header().hash; }
+    operator bool() const { return !empty(); }
     bool operator==(Symbol symbol) const { return c_str() == symbol.c_str(); }
     bool operator!=(Symbol symbol) const { return c_str() != symbol.c_str(); }
-    bool operator==(const char* s) const { return c_str() == Symbol(s).c_str(); }
-    bool operator!=(const char* s) const { return c_str() != Symbol(s).c_str(); }
+    bool operator==(const char* s) const { return view() == s; }
+    bool operator!=(const char* s) const { return view() != s; }
     bool empty() const { return *str_ == '\0'; }
     bool is_anonymous() const { return (*this) == "_"; }
     std::string remove_quotation() const;
 
+    /// Returns the @p Symbol for @p str if it has already been interned - without interning it.
+    static std::optional<Symbol> lookup(std::string_view str);
+    /// Number of interned strings.
+    static size_t num();
+
+    struct Header {
+        uint64_t hash;
+        uint32_t size;
+    };
+
 private:
     Symbol(int /* just a dummy */)
         : str_((const char*)(1))
     {}
+    explicit Symbol(const char* str, int /*interned*/)
+        : str_(str)
+    {}
 
-    struct Table {
-        ~Table() {
-            for (auto s : set)
-                free((void*) const_cast<char*>(s));
-        }
+    const Header& header() const { return reinterpret_cast<const Header*>(str_)[-1]; }
+    static const char* insert(std::string_view);
 
-        HashSet<const char*, StrHash> set;
+    struct Empty {
+        Header header;
+        char str[1];
     };
-
-    void insert(const char* str);
+    static const Empty empty_;
 
     const char* str_;
-    static Table table_;
 };
 
 inline Symbol operator+(Symbol s1, Symbol s2) { return std::string(s1.c_str()) + s2.str(); }
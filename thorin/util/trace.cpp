@@ -0,0 +1,146 @@
+#include "thorin/util/trace.h"
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace thorin {
+
+namespace {
+
+struct Event {
+    const char* name;
+    std::string msg; ///< Used instead of @p name for instant events.
+    uint64_t begin;
+    uint64_t end;
+    bool instant;
+};
+
+struct Buffer {
+    Buffer(size_t tid)
+        : tid(tid)
+    {}
+
+    void emplace(Event&& event) {
+        events[num++ % Trace::Capacity] = std::move(event);
+    }
+
+    std::array<Event, Trace::Capacity> events;
+    size_t num = 0; ///< Events recorded so far - including the overwritten ones.
+    size_t tid;
+};
+
+/// Owns the @p Buffer%s of all threads - also of the ones that have already finished - and writes the trace at exit.
+class Registry {
+public:
+    Registry() {
+        if (auto filename = std::getenv("THORIN_TRACE")) {
+            filename_ = filename;
+            Trace::enable();
+        }
+    }
+    ~Registry() {
+        if (!filename_.empty()) {
+            std::ofstream ofs(filename_);
+            Trace::flush(ofs);
+        }
+    }
+
+    Buffer* add() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return buffers_.emplace_back(std::make_unique<Buffer>(buffers_.size() + 1)).get();
+    }
+
+    template<class F>
+    void for_each(F f) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        for (auto& buffer : buffers_)
+            f(*buffer);
+    }
+
+private:
+    std::string filename_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+const auto start = std::chrono::steady_clock::now();
+
+/// A function-local static such that spans in static initializers of other translation units already work.
+Registry& registry() {
+    static Registry registry;
+    return registry;
+}
+
+const Registry& init = registry();
+
+/// Only registers a @p Buffer once the thread actually records something.
+Buffer& buffer() {
+    thread_local Buffer* buffer = registry().add();
+    return *buffer;
+}
+
+std::ostream& quote(std::ostream& os, const std::string& s) {
+    os << '"';
+    for (auto c : s) {
+        switch (c) {
+            case '"':  os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n";  break;
+            case '\t': os << "\\t";  break;
+            default:
+                if ((unsigned char)c < 0x20)
+                    os << ' ';
+                else
+                    os << c;
+        }
+    }
+    return os << '"';
+}
+
+}
+
+std::atomic<bool> Trace::enabled_(false);
+
+uint64_t Trace::now() {
+    // never 0 - TraceSpan uses 0 for "not recording"
+    return 1 + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Trace::complete(const char* name, uint64_t begin, uint64_t end) { buffer().emplace({name, {}, begin, end, false}); }
+
+void Trace::instant(std::string msg) {
+    auto time = now();
+    buffer().emplace({nullptr, std::move(msg), time, time, true});
+}
+
+void Trace::flush(std::ostream& os) {
+    os << "{\"traceEvents\": [";
+    const char* sep = "\n";
+    registry().for_each([&](const Buffer& buffer) {
+        auto num = std::min(buffer.num, Capacity);
+        for (size_t i = buffer.num - num; i != buffer.num; ++i) {
+            auto& event = buffer.events[i % Capacity];
+            os << sep << "{\"name\": ";
+            quote(os, event.instant ? event.msg : event.name);
+            os << ", \"ph\": \"" << (event.instant ? 'i' : 'X') << "\", \"ts\": " << double(event.begin) / 1000.0;
+            if (event.instant)
+                os << ", \"s\": \"t\"";
+            else
+                os << ", \"dur\": " << double(event.end - event.begin) / 1000.0;
+            os << ", \"pid\": 1, \"tid\": " << buffer.tid << "}";
+            sep = ",\n";
+        }
+    });
+    os << "\n]}" << std::endl;
+}
+
+void Trace::clear() {
+    registry().for_each([](Buffer& buffer) { buffer.num = 0; });
+}
+
+}
@@ -0,0 +1,72 @@
+#ifndef THORIN_UTIL_TRACE_H
+#define THORIN_UTIL_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace thorin {
+
+/**
+ * Timeline traces in the Chrome trace-event format - open them with @c chrome://tracing or Perfetto.
+ * Set the environment variable @c THORIN_TRACE to a file name to record all @p TraceSpan%s and log lines;
+ * the trace is written to this file at exit.
+ * Each thread records into its own ring buffer, so recording takes no locks.
+ * If a buffer is full, the oldest events of this thread are overwritten.
+ */
+class Trace {
+    Trace() = delete;
+    Trace(const Trace&) = delete;
+    Trace& operator= (const Trace&) = delete;
+
+public:
+    static constexpr size_t Capacity = 1 << 16; ///< Events per thread.
+
+    /// A plain flag which orders nothing - so use it to toggle tracing but not to synchronize with other threads.
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void enable(bool flag = true) { enabled_.store(flag, std::memory_order_relaxed); }
+    static uint64_t now(); ///< Nanoseconds since start-up.
+
+    //@{ record events
+    static void complete(const char* name, uint64_t begin, uint64_t end); ///< @p name must outlive the trace.
+    static void instant(std::string msg);
+    //@}
+
+    /// Writes all recorded events as JSON; only call this while no other thread records.
+    static void flush(std::ostream&);
+    /// Drops all recorded events.
+    static void clear();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+/// Records the time from its construction to its destruction as one event named @p name.
+class TraceSpan {
+public:
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator= (const TraceSpan&) = delete;
+
+    TraceSpan(const char* name)
+        : name_(name)
+        , begin_(Trace::enabled() ? Trace::now() : 0)
+    {}
+    ~TraceSpan() {
+        if (begin_ != 0 && Trace::enabled())
+            Trace::complete(name_, begin_, Trace::now());
+    }
+
+private:
+    const char* name_;
+    uint64_t begin_;
+};
+
+}
+
+#define THORIN_TRACE_CONCAT_(a, b) a ## b
+#define THORIN_TRACE_CONCAT(a, b) THORIN_TRACE_CONCAT_(a, b)
+/// Traces the rest of the current block as @p name.
+#define THORIN_TRACE(name) thorin::TraceSpan THORIN_TRACE_CONCAT(thorin_trace_span_, __LINE__)(name)
+
+#endif
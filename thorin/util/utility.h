@@ -5,6 +5,7 @@
 #include <memory>
 #include <queue>
 #include <stack>
+#include <vector>
 
 #ifdef _MSC_VER
 #include <intrin.h>
@@ -55,6 +56,13 @@ T pop(std::stack<T>& stack) {
     return val;
 }
 
+template<class T>
+T pop(std::vector<T>& vector) {
+    auto val = vector.back();
+    vector.pop_back();
+    return val;
+}
+
 template<class T>
 struct Push {
     Push(T& t, T new_val)
@@ -186,6 +194,38 @@ inline size_t bitcount(uint64_t v) {
 #endif
 }
 
+/// Number of trailing zero bits in @p v which must not be zero.
+inline size_t trailing_zeros(uint64_t v) {
+    assert(v != 0);
+#if defined(__GNUC__) | defined(__clang__)
+    return __builtin_ctzll(v);
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return i;
+#else
+    size_t i = 0;
+    for (; (v & 1_u64) == 0; v >>= 1_u64) ++i;
+    return i;
+#endif
+}
+
+/// Number of leading zero bits in @p v which must not be zero.
+inline size_t leading_zeros(uint64_t v) {
+    assert(v != 0);
+#if defined(__GNUC__) | defined(__clang__)
+    return __builtin_clzll(v);
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return 63 - i;
+#else
+    size_t i = 0;
+    for (; (v & (1_u64 << 63_u64)) == 0; v <<= 1_u64) ++i;
+    return i;
+#endif
+}
+
 //@}
 
 }
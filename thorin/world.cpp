@@ -1,11 +1,14 @@
 #include <algorithm>
 #include <functional>
+#include <mutex>
 
 #include "thorin/world.h"
 #include "thorin/normalize.h"
 #include "thorin/fe/parser.h"
 #include "thorin/analyses/free_vars_params.h"
+#include "thorin/transform/import.h"
 #include "thorin/transform/reduce.h"
+#include "thorin/util/trace.h"
 
 namespace thorin {
 
@@ -115,14 +118,56 @@ const Def* World::bound(const Def* q, Range<I> defs) {
 //------------------------------------------------------------------------------
 
 #ifndef NDEBUG
-bool World::Lock::alloc_guard_ = false;
+thread_local bool World::Lock::alloc_guard_ = false;
 #endif
 
-World::World(Debug dbg)
-    : debug_(dbg)
+std::array<World*, World::Max_Worlds> World::registry_;
+static std::mutex registry_mutex;
+static std::vector<uint32_t> free_indices;
+static uint32_t num_indices = 0;
+
+uint32_t World::register_world(World* world) {
+    std::lock_guard<std::mutex> guard(registry_mutex);
+    uint32_t index;
+    if (free_indices.empty()) {
+        assert(num_indices != Max_Worlds && "too many World%s alive at the same time");
+        index = num_indices++;
+    } else {
+        index = pop(free_indices);
+    }
+    registry_[index] = world;
+    return index;
+}
+
+void World::unregister_world(uint32_t index) {
+    std::lock_guard<std::mutex> guard(registry_mutex);
+    registry_[index] = nullptr;
+    free_indices.emplace_back(index);
+}
+
+template<class T>
+static bool belongs_to(const World& world, T* def) { return def != nullptr && &def->world() == &world; }
+
+template<class T, size_t N>
+static bool belongs_to(const World& world, const std::array<T*, N>& defs) {
+    return std::all_of(defs.begin(), defs.end(), [&](auto def) { return belongs_to(world, def); });
+}
+
+bool World::builtins_belong_to_this() const {
+#define CODE(T, member) && belongs_to(*this, member)
+#define CODE_ARRAY(T, member, N) CODE(T, member)
+    return belongs_to(*this, universe_) THORIN_WORLD_BUILTINS(CODE, CODE_ARRAY);
+#undef CODE_ARRAY
+#undef CODE
+}
+
+World::World(Bootstrap, Debug dbg)
+    : index_(register_world(this))
+    , debug_(dbg)
     , root_page_(new Zone)
     , cur_page_(root_page_.get())
 {
+    THORIN_TRACE("World::World(Bootstrap)");
     universe_ = insert<Universe>(0, *this);
     kind_qualifier_ = axiom(universe(), {"*Q"});
     type_qualifier_ = axiom(kind_qualifier(), {"ℚ"});
@@ -171,14 +216,109 @@ World::World(Debug dbg)
     multi_recursor_ = axiom("Recₘ*M", "Π*A. Π[Π[*A,*A]. *A]. Πq: ℚ. Π*Mq. *A", normalize_multi_recursor);
     rank_ = app(app(multi_recursor(), lit_arity(0)), fe::parse(*this, "λ[acc: *A, curr: *A]. ASucc (ᵁ, acc)"));
 
+    for (size_t i = 0; i != 4; ++i) {
+        unit_kind_[i] = variadic(lit_arity(0), kind_star_[i]);
+        unit_kind_val_[i] = pack(lit_arity(0), unit_[i]);
+    }
+
     cn_br_      = axiom("br",      "cn[bool, cn[], cn[]]");
     cn_end_     = lambda(cn(unit()), {"end"});
-
+    assert(builtins_belong_to_this());
 }
 
 World::~World() {
     for (auto def : defs_)
-        def->~Def();
+        def->~Def();    unregister_world(index_);
+}
+
+template<class T>
+static void remap(const Def2Def& old2new, T* old_def, T*& new_def) {
+    assert(old2new.contains(old_def) && "built-in Def not copied from the prelude");
+    new_def = static_cast<T*>(const_cast<Def*>(old2new.find(old_def)->second));
+}
+
+template<class T, size_t N>
+static void remap(const Def2Def& old2new, const std::array<T*, N>& old_defs, std::array<T*, N>& new_defs) {
+    for (size_t i = 0; i != N; ++i)
+        remap(old2new, old_defs[i], new_defs[i]);
+}
+
+World::World(const World& prelude, Debug dbg)
+    : index_(register_world(this))
+    , debug_(dbg)
+    , root_page_(new Zone)
+    , cur_page_(root_page_.get())
+{
+    THORIN_TRACE("World::World(prelude)");
+    universe_ = insert<Universe>(0, *this);
+
+    // the prelude has already been checked - and checks would need the built-in Def%s which are only remapped below
+    auto expensive_checks = expensive_checks_;
+    expensive_checks_ = false;
+
+    // types and ops of structural Defs are older than the Def itself - only ops of nominals may be younger
+    std::vector<const Def*> defs(prelude.defs().begin(), prelude.defs().end());
+    std::sort(defs.begin(), defs.end(), [](auto d1, auto d2) { return d1->gid() < d2->gid(); });
+
+    Def2Def old2new;
+    old2new[prelude.universe()] = universe();
+    for (auto def : defs) {
+        if (def->isa<Universe>()) continue;
+        auto type = old2new[def->type()];
+        if (def->is_nominal()) {
+            old2new[def] = def->stub(*this, type, def->debug());
+        } else {
+            DefArray ops(def->num_ops(), [&](auto i) { return old2new[def->op(i)]; });
+            Box box;
+            if (auto lit = def->isa<Lit>()) box = lit->box();
+            if (auto var = def->isa<Var>()) box = Box(var->index());
+            old2new[def] = raw_rebuild(def->tag(), type, ops, box, def->debug());
+        }
+    }
+
+    for (auto def : defs) {
+        if (!def->is_nominal()) continue;
+        auto nominal = const_cast<Def*>(old2new[def]);
+        for (size_t i = 0, e = def->num_ops(); i != e; ++i) {
+            if (auto op = def->op(i))
+                nominal->set(i, old2new[op]);
+        }
+    }
+
+    for (auto [name, def] : prelude.externals())
+        make_external(old2new[def]);
+    expensive_checks_ = expensive_checks;
+
+#define CODE(T, member) remap(old2new, prelude.member, member);
+#define CODE_ARRAY(T, member, N) CODE(T, member)
+    THORIN_WORLD_BUILTINS(CODE, CODE_ARRAY)
+#undef CODE_ARRAY
+#undef CODE
+    assert(builtins_belong_to_this());
+}
+
+const World& World::prelude() {
+    static const World prelude(Bootstrap{});
+    return prelude;
+}
+
+Stats World::stats() const {
+#ifdef THORIN_ENABLE_STATS
+    auto result = stats_;
+    std::tie(result.probe_length_sum, result.probe_length_max) = defs_.probe_lengths();
+    result.num_defs = defs_.size();
+    result.type_check_hits = type_check_.hits();
+    result.type_check_misses = type_check_.misses();
+    return result;
+#else
+    return {};
+#endif
+}
+
+void World::merge(World& other) {
+    auto importer = Importer::into(*this);
+    for (auto [name, def] : other.externals())
+        make_external(importer.import(def));
 }
 
 const Lit* World::lit_arity(const Def* q, u64 a, Loc loc) {
@@ -187,7 +327,7 @@ const Lit* World::lit_arity(const Def* q, u64 a, Loc loc) {
     auto result = lit(kind_arity(q), {a}, loc);
 
     if (result->gid() >= cur)
-        result->debug().set(std::to_string(a) + "ₐ");
+        result->set_name(std::to_string(a) + "ₐ");
 
     return result;
 }
@@ -206,8 +346,11 @@ const Def* World::app(const Def* callee, const Def* arg, Debug dbg) {
     if (assignable(callee_type->domain(), arg)) {
         if (auto axiom = get_axiom(callee); axiom && !callee_type->codomain()->isa<Pi>()) {
             if (auto normalizer = axiom->normalizer()) {
-                if (auto result = normalizer(callee, arg, dbg))
+                THORIN_STATS(++stats_.normalizers[axiom].calls);
+                if (auto result = normalizer(callee, arg, dbg)) {
+                    THORIN_STATS(++stats_.normalizers[axiom].hits);
                     return result;
+                }
             }
         }
 
@@ -223,6 +366,7 @@ const Def* World::app(const Def* callee, const Def* arg, Debug dbg) {
                 return cache;
 
             // TODO could reduce those with only affine return type, but requires always rebuilding the reduced body?
+            // until then, App::unfold reduces the affine ones on demand and caches them in affine_unfolds_
             if (!lambda->maybe_affine() && !lambda->codomain()->maybe_affine()) {
                 assert(app->cache() == nullptr);
                 auto res = reduce(lambda->body(), app->arg());
@@ -364,7 +508,7 @@ const Lit* World::lit_index(const Lit* a, u64 i, Loc loc) {
                 ((s += char(char(0x80) + char(aa % 10))) += char(0x82)) += char(0xe2);
 
             std::reverse(s.begin() + b, s.end());
-            result->debug().set(s);
+            result->set_name(s);
         }
 
         return result;
@@ -393,7 +537,7 @@ const Def* World::index_succ(const Def* index, Debug dbg) {
 
 const Def* World::insert(const Def* def, const Def* i, const Def* value, Debug dbg) {
     // TODO type check insert node
-    return unify<Insert>(2, def->type(), def, i, value, dbg);
+    return unify<Insert>(3, def->type(), def, i, value, dbg);
 }
 
 const Def* World::insert(const Def* def, size_t i, const Def* value, Debug dbg) {
@@ -632,7 +776,7 @@ const Def* World::sigma(const Def* q, Defs defs, Debug dbg) {
     for (size_t i = 0, e = defs.size(); i != e; ++i) {
         // check whether any free variable is substructurally typed
         // free vars of index larger than i-1 don't matter, because they will be false in 'substructural' anyway
-        if ((defs[i]->free_vars() & substructural).any())
+        if (defs[i]->free_vars().intersects(substructural))
             errorf("type [{, }] is dependent on substructurally-typed terms at position {} and is thus not allowed", defs, i);
 
         substructural >>= 1;
@@ -769,6 +913,66 @@ Unknown* World::unknown(Loc loc) {
     return insert<Unknown>(0, Debug(loc, oss.str()), *this);
 }
 
+const Def* World::rebuild(Def::Tag tag, const Def* type, Defs ops, Box box, Debug dbg) {
+    using Tag = Def::Tag;
+    switch (tag) {
+        case Tag::Universe:     return universe();
+        case Tag::KindArity:
+        case Tag::KindMulti:
+        case Tag::KindStar:     return kind(tag, ops[0]);
+        case Tag::App:          return app(ops[0], ops[1], dbg);
+        case Tag::Lambda:       return lambda(type->qualifier(), type->as<Pi>()->domain(), ops[0], ops[1], dbg);
+        case Tag::Param:        return param(ops[0]->as<Lambda>(), dbg);
+        case Tag::Pi:           return pi(ops[0], ops[1], dbg);
+        case Tag::Extract:      return extract(ops[0], ops[1], dbg);
+        case Tag::Insert:       return insert(ops[0], ops[1], ops[2], dbg);
+        case Tag::Tuple:        return tuple(ops, dbg);
+        case Tag::Pack:         return pack(type->arity(), ops[0], dbg);
+        case Tag::Sigma:        return sigma(type->qualifier(), ops, dbg);
+        case Tag::Variadic:     return variadic(ops[0], ops[1], dbg);
+        case Tag::Match:        return match(ops[0], ops.skip_front(), dbg);
+        case Tag::Variant:      return variant(type, ops, dbg);
+        case Tag::Pick:         return pick(type, ops[0], dbg);
+        case Tag::Intersection: return intersection(type, ops, dbg);
+        case Tag::Lit:          return lit(type, box, dbg);
+        case Tag::Bot:          return bot(type);
+        case Tag::Top:          return top(type);
+        case Tag::Singleton:    return singleton(ops[0], dbg);
+        case Tag::Var:          return var(type, box.get_u64(), dbg);
+        default: THORIN_UNREACHABLE;
+    }
+}
+
+const Def* World::raw_rebuild(Def::Tag tag, const Def* type, Defs ops, Box box, Debug dbg) {
+    using Tag = Def::Tag;
+    switch (tag) {
+        case Tag::Universe:     return universe();
+        case Tag::KindArity:
+        case Tag::KindMulti:
+        case Tag::KindStar:     return unify<Kind>(1, *this, tag, ops[0]);
+        case Tag::App:          return unify<App>(2, type, ops[0], ops[1], dbg);
+        case Tag::Lambda:       return unify<Lambda>(2, type->as<Pi>(), ops[0], ops[1], dbg);
+        case Tag::Param:        return unify<Param>(1, type, ops[0]->as<Lambda>(), dbg);
+        case Tag::Pi:           return unify<Pi>(2, type, ops[0], ops[1], dbg);
+        case Tag::Extract:      return unify<Extract>(2, type, ops[0], ops[1], dbg);
+        case Tag::Insert:       return unify<Insert>(3, type, ops[0], ops[1], ops[2], dbg);
+        case Tag::Tuple:        return unify<Tuple>(ops.size(), type, ops, dbg);
+        case Tag::Pack:         return unify<Pack>(1, type, ops[0], dbg);
+        case Tag::Sigma:        return unify<Sigma>(ops.size(), type, ops, dbg);
+        case Tag::Variadic:     return unify<Variadic>(2, type, ops[0], ops[1], dbg);
+        case Tag::Match:        return unify<Match>(ops.size(), type, ops[0], ops.skip_front(), dbg);
+        case Tag::Variant:      return unify<Variant>(ops.size(), type, SortedDefSet(ops.begin(), ops.end()), dbg);
+        case Tag::Pick:         return unify<Pick>(1, type, ops[0], dbg);
+        case Tag::Intersection: return unify<Intersection>(ops.size(), type, SortedDefSet(ops.begin(), ops.end()), dbg);
+        case Tag::Lit:          return unify<Lit>(0, type, box, dbg);
+        case Tag::Bot:          return unify<BotTop>(0, type, false);
+        case Tag::Top:          return unify<BotTop>(0, type, true);
+        case Tag::Singleton:    return unify<Singleton>(1, ops[0], dbg);
+        case Tag::Var:          return unify<Var>(0, type, box.get_u64(), dbg);
+        default: THORIN_UNREACHABLE;
+    }
+}
+
 const Def* World::match(const Def* def, Defs handlers, Debug dbg) {
     auto type = def->destructing_type();
 
@@ -809,7 +1013,7 @@ const Lit* World::lit_nat(int64_t val, Loc loc) {
     auto cur = Def::gid_counter();
     auto result = lit(type_nat(), {val}, {loc});
     if (result->gid() >= cur)
-        result->debug().set(std::to_string(val));
+        result->set_name(std::to_string(val));
     return result;
 }
 
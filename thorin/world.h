@@ -6,6 +6,7 @@
 #include <string>
 
 #include "thorin/def.h"
+#include "thorin/stats.h"
 #include "thorin/tables.h"
 #include "thorin/util/iterator.h"
 #include "thorin/util/symbol.h"
@@ -26,6 +27,41 @@ std::array<const Def*, 2> infer_width_and_shape(World&, const Def*);
 
 //------------------------------------------------------------------------------
 
+/**
+ * Built-in Def%s of each World besides the @p Universe: @p m(T, member) declares a @c T and @p a(T, member, N) a @c std::array<T, N>.
+ * The members are declared from this list such that @c World(const World& prelude, Debug) can't forget to remap one of them.
+ */
+#define THORIN_WORLD_BUILTINS(m, a)                 \
+    m(const Axiom*, kind_qualifier_)                \
+    m(const Axiom*, type_qualifier_)                \
+    m(const Axiom*, arity_succ_)                    \
+    m(const Axiom*, arity_eliminator_)              \
+    m(const Axiom*, arity_recursor_to_arity_)       \
+    m(const Axiom*, arity_recursor_to_multi_)       \
+    m(const Axiom*, arity_recursor_to_star_)        \
+    m(const Axiom*, index_zero_)                    \
+    m(const Axiom*, index_succ_)                    \
+    m(const Axiom*, index_eliminator_)              \
+    m(const Axiom*, multi_recursor_)                \
+    m(const Def*,   rank_)                          \
+    a(const Lit*,   qualifier_,     4)              \
+    a(const Lit*,   unit_,          4)              \
+    a(const Def*,   unit_val_,      4)              \
+    a(const Def*,   unit_kind_,     4)              \
+    a(const Def*,   unit_kind_val_, 4)              \
+    a(const Kind*,  kind_arity_,    4)              \
+    a(const Kind*,  kind_multi_,    4)              \
+    a(const Kind*,  kind_star_,     4)              \
+    a(const Axiom*, BOp_,           Num<BOp>)       \
+    a(const Axiom*, NOp_,           Num<NOp>)       \
+    m(const Axiom*, type_bool_)                     \
+    m(const Axiom*, type_nat_)                      \
+    m(const Lit*,   lit_nat_0_)                     \
+    a(const Lit*,   lit_bool_,      2)              \
+    a(const Lit*,   lit_nat_,       7)              \
+    m(const Axiom*, cn_br_)                         \
+    m(Lambda*,      cn_end_)
+
 class World {
 public:
     struct DefHash {
@@ -47,9 +83,21 @@ public:
     World& operator=(const World&) = delete;
     World(const World&) = delete;
 
-    World(Debug dbg = {});
+    /// Copies the built-in Def%s from the @p prelude.
+    World(Debug dbg = {}) : World(prelude(), dbg) {}
+    /**
+     * Copies the built-in Def%s of @p prelude instead of building - and parsing - them from scratch.
+     * @p prelude must have been constructed as a World of the same class.
+     */
+    World(const World& prelude, Debug dbg);
+    /// Tag to build all built-in Def%s from scratch - by parsing their types.
+    struct Bootstrap {};
+    World(Bootstrap, Debug dbg = {});
     ~World();
 
+    /// A shared and immutable World which only consists of the built-in Def%s; it is bootstrapped on first use.
+    static const World& prelude();
+
     //@{ get Debug information
     Debug& debug() const { return debug_; }
     Loc loc() const { return debug_; }
@@ -109,7 +157,7 @@ public:
     //@{ create Units
     const Def* unit(Qualifier q = Qualifier::u) { return unit_[size_t(q)]; }
     const Def* unit(const Def* def) { auto q = get_qualifier(def); return q ? unit(*q) : lit_arity(def, 1); }
-    const Def* unit_kind(Qualifier q = Qualifier::u) { return variadic(lit_arity(0), kind_star(q)); }
+    const Def* unit_kind(Qualifier q = Qualifier::u) { return unit_kind_[size_t(q)]; }
     const Def* unit_kind(const Def* q) { return variadic(lit_arity(0), kind_star(q)); }
     //@}
 
@@ -139,7 +187,7 @@ public:
     //@{ create unit values
     const Def* val_unit(Qualifier q = Qualifier::u) { return unit_val_[size_t(q)]; }
     const Def* val_unit(const Def* def) { auto q = get_qualifier(def); return q ? val_unit(*q) : index_zero(lit_arity(def, 1)); }
-    const Def* val_unit_kind(Qualifier q = Qualifier::u) { return pack(lit_arity(0), unit(q)); }
+    const Def* val_unit_kind(Qualifier q = Qualifier::u) { return unit_kind_val_[size_t(q)]; }
     const Def* val_unit_kind(const Def* q) { return pack(lit_arity(0), unit(q)); }
     //@}
 
@@ -283,6 +331,13 @@ public:
     }
     bool is_external(const Def* def) const { return externals_.contains(def->name()); }
     const Def* lookup_external(Symbol s) const { return find(externals_, s); }
+    /**
+     * Imports all externals of @p other into this World and makes them external here.
+     * @p Axiom%s and externals are identified by name and structural Def%s are hash-consed:
+     * everything this World already contains - in particular its built-in Def%s - is shared instead of copied.
+     * @p Symbol%s are interned globally and, hence, need no remapping.
+     */
+    void merge(World& other);
     auto external_lambdas() const { return map_range(range(externals_,
                 [](auto p) { return p.second->template isa<Lambda>(); }),
                 [](auto p) { return p.second->as_lambda(); });
@@ -311,19 +366,63 @@ public:
 
     //@{ misc
     const DefSet& defs() const { return defs_; }
+    FreeVarsTable& free_vars_table() { return free_vars_table_; }
+    DebugTable& debug_table() { return debug_table_; }
+    /// Fresh stamp for Def::generation - bumped whenever a nominal is mutated.
+    uint32_t next_generation() { return ++generation_; }
+    /// Stamp of the last mutation of any nominal.
+    uint32_t generation() const { return generation_; }
+    /// Stamp of the Scope whose marks on the Def%s are currently valid - 0 if none.
+    uint64_t& scope_stamp() { return scope_stamp_; }
+    /// Fresh stamp for a Scope.
+    uint64_t next_scope_stamp() { return ++num_scope_stamps_; }
+    /// Slot of this World in the process-wide registry of World%s - see @p World::of.
+    uint32_t index() const { return index_; }
+    /// The World registered at @p index - this is how a Def finds its World without walking up its type chain.
+    static World& of(uint32_t index) { return *registry_[index]; }
+    static constexpr size_t Max_Worlds = 1 << 16;
+    /// Side cache of App::unfold for the affine cases World::app does not reduce.
+    Def2Def& affine_unfolds() { return affine_unfolds_; }
     auto lambdas() const { return map_range(range(defs_,
                 [](auto def) { return def->isa_lambda(); }),
                 [](auto def) { return def->as_lambda(); }); }
     const Def* types_from_tuple_type(const Def* type);
     //@}
 
+    //@{ statistics
+    /// Snapshot of the counters of this World - empty unless built with @c THORIN_ENABLE_STATS.
+    Stats stats() const;
+#ifdef THORIN_ENABLE_STATS
+    Stats& counters() { return stats_; } ///< For instrumented code outside of World.
+#endif
+    //@}
+
+    //@{ rebuild structural Def%s from their parts - e.g. when loading them from disk
+    /**
+     * Builds the structural Def of kind @p tag via the regular factory methods - i.e. with normalization and checks.
+     * @p box holds the value of a @p Lit or the index of a @p Var and is ignored otherwise.
+     */
+    const Def* rebuild(Def::Tag tag, const Def* type, Defs ops, Box box = {}, Debug dbg = {});
+    /// Like @p rebuild but hash-conses the Def exactly as given - without normalization and checks. Only use this for trusted input.
+    const Def* raw_rebuild(Def::Tag tag, const Def* type, Defs ops, Box box = {}, Debug dbg = {});
+    //@}
+
     friend void swap(World& w1, World& w2) {
         using std::swap;
         swap(w1.debug_,            w2.debug_);
         swap(w1.defs_,             w2.defs_);
+        swap(w1.free_vars_table_,  w2.free_vars_table_);
+        swap(w1.debug_table_,      w2.debug_table_);
+        swap(w1.generation_,       w2.generation_);
+        swap(w1.scope_stamp_,      w2.scope_stamp_);
+        swap(w1.num_scope_stamps_, w2.num_scope_stamps_);
+        swap(w1.affine_unfolds_,   w2.affine_unfolds_);
         swap(w1.externals_,        w2.externals_);
         swap(w1.axioms_,           w2.axioms_);
         swap(w1.universe_->world_, w2.universe_->world_);
+        swap(registry_[w1.index_], registry_[w2.index_]);
+        swap(w1.index_,            w2.index_);
+        THORIN_STATS(swap(w1.stats_, w2.stats_));
 #ifndef NDEBUG
         swap(w1.breakpoints_,      w2.breakpoints_);
         swap(w1.track_history_,    w2.track_history_);
@@ -357,12 +456,17 @@ protected:
         if (breakpoints_.contains(def->gid())) THORIN_BREAK;
 #endif
         assert(!def->is_nominal());
+        THORIN_STATS(auto capacity = defs_.capacity());
         auto [i, success] = defs_.emplace(def);
+        THORIN_STATS(stats_.rehashes += defs_.capacity() != capacity);
         if (success) {
+            THORIN_STATS(++stats_.nodes[size_t(def->tag())].created);
+            def->debug_ = debug_table_.intern_deferred();
             def->finalize();
             return def;
         }
 
+        THORIN_STATS(++stats_.nodes[size_t(def->tag())].deduped);
         dealloc<T>(def);
         return static_cast<const T*>(*i);
     }
@@ -373,8 +477,11 @@ protected:
 #ifndef NDEBUG
         if (breakpoints_.contains(def->gid())) THORIN_BREAK;
 #endif
+        THORIN_STATS(auto capacity = defs_.capacity());
         auto p = defs_.emplace(def);
         assert_unused(p.second);
+        THORIN_STATS(stats_.rehashes += defs_.capacity() != capacity);
+        THORIN_STATS(++stats_.nodes[size_t(def->tag())].nominals);
         return def;
     }
 
@@ -390,7 +497,7 @@ protected:
             assert((alloc_guard_ = !alloc_guard_) && "you are not allowed to recursively invoke alloc");
         }
         ~Lock() { alloc_guard_ = !alloc_guard_; }
-        static bool alloc_guard_;
+        static thread_local bool alloc_guard_;
     };
 #else
     struct Lock { ~Lock() {} };
@@ -413,7 +520,9 @@ protected:
             cur_page_->next.reset(page);
             cur_page_ = page;
             buffer_index_ = 0;
+            THORIN_STATS(stats_.zone_bytes.emplace_back(0));
         }
+        THORIN_STATS(stats_.zone_bytes.back() += num_bytes);
 
         auto result = new (cur_page_->buffer + buffer_index_) T(args...);
         buffer_index_ += num_bytes;
@@ -427,49 +536,44 @@ protected:
         size_t num_bytes = num_bytes_of<T>(def->num_ops());
         num_bytes = (num_bytes + (sizeof(void*) - 1)) & ~(sizeof(void*)-1);
         def->~T();
-        if (ptrdiff_t(buffer_index_ - num_bytes) > 0) // don't care otherwise
+        if (ptrdiff_t(buffer_index_ - num_bytes) > 0) { // don't care otherwise
             buffer_index_-= num_bytes;
+            THORIN_STATS(++stats_.reclaims);
+            THORIN_STATS(stats_.reclaimed_bytes += num_bytes);
+            THORIN_STATS(stats_.zone_bytes.back() -= num_bytes);
+        }
         assert(buffer_index_ % alignof(T) == 0);
     }
 
+    /// Are all built-in Def%s set and owned by this World?
+    bool builtins_belong_to_this() const;
+
+    static uint32_t register_world(World*);
+    static void unregister_world(uint32_t index);
+
+    static std::array<World*, Max_Worlds> registry_;
+    uint32_t index_;
     mutable Debug debug_;
     std::unique_ptr<Zone> root_page_;
     Zone* cur_page_;
     size_t buffer_index_ = 0;
     DefSet defs_;
+    FreeVarsTable free_vars_table_;
+    DebugTable debug_table_;
+    uint32_t generation_ = 0;
+    uint64_t scope_stamp_ = 0;
+    uint64_t num_scope_stamps_ = 0;
+    Def2Def affine_unfolds_;
     SymbolMap<const Axiom*> axioms_;
     SymbolMap<const Def*> externals_;
     const Universe* universe_;
-    const Axiom* kind_qualifier_;
-    const Axiom* type_qualifier_;
-    const Axiom* arity_succ_;
-    const Axiom* arity_eliminator_;
-    const Axiom* arity_recursor_to_arity_;
-    const Axiom* arity_recursor_to_multi_;
-    const Axiom* arity_recursor_to_star_;
-    const Axiom* index_zero_;
-    const Axiom* index_succ_;
-    const Axiom* index_eliminator_;
-    const Axiom* multi_recursor_;
-    const Def* rank_;
-    std::array<const Lit*, 4> qualifier_;
-    std::array<const Lit*, 4> unit_;
-    std::array<const Def*, 4> unit_val_;
-    std::array<const Def*, 4> unit_kind_;
-    std::array<const Def*, 4> unit_kind_val_;
-    std::array<const Kind*, 4> kind_arity_;
-    std::array<const Kind*, 4> kind_multi_;
-    std::array<const Kind*, 4> kind_star_;
-    std::array<const Axiom*, Num<BOp>> BOp_;
-    std::array<const Axiom*, Num<NOp>> NOp_;
-    const Axiom* type_bool_;
-    const Axiom* type_nat_;
-    const Lit* lit_nat_0_;
-    std::array<const Lit*, 2> lit_bool_;
-    std::array<const Lit*, 7> lit_nat_;
-    const Axiom* cn_br_;
-    Lambda* cn_end_;
+#define CODE(T, member) T member = {};
+#define CODE_ARRAY(T, member, N) std::array<T, N> member = {};
+    THORIN_WORLD_BUILTINS(CODE, CODE_ARRAY)
+#undef CODE_ARRAY
+#undef CODE
     TypeCheck type_check_;
+    THORIN_STATS(Stats stats_;)
 #ifndef NDEBUG
     Breakpoints breakpoints_;
     bool track_history_ = false;